@@ -3,21 +3,16 @@
 #include "saturn/vdp1.h"
 #include "saturn/vdp2.h"
 #include "saturn/shared.h"
+#include "saturn/text.h"
+#include "saturn/palette.h"
+#include "saturn/upload.h"
+#include "saturn/dmac.h"
+#include "config.h"
 
-#define SCREEN_WIDTH 320
-#define SCREEN_HEIGHT 224
-#define BITMAP_WIDTH 512
-#define BITMAP_HEIGHT 256
-#define FONT_WIDTH 8
-#define FONT_HEIGHT 8
-#define FONT_SPACING 1
+#define TEXT_COLUMNS 40
+#define TEXT_ROWS 28
 
-typedef struct {
-    char ch;
-    u8 rows[FONT_HEIGHT];
-} Glyph;
-
-static const Glyph kGlyphs[] = {
+static const TextGlyph kGlyphs[] = {
     { ' ', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },
     { 'D', { 0xFC, 0x82, 0x81, 0x81, 0x81, 0x82, 0xFC, 0x00 } },
     { 'E', { 0xFF, 0x80, 0x80, 0xFE, 0x80, 0x80, 0xFF, 0x00 } },
@@ -29,6 +24,14 @@ static const Glyph kGlyphs[] = {
     { '!', { 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00 } },
 };
 
+static const TextConfig kTextConfig = {
+    .layer = BG_NBG1,
+    .char_addr = 0x40000,
+    .map_addr = 0x42000,
+    .palette = 0,
+    .priority = 7,
+};
+
 static int string_length(const char* text) {
     int length = 0;
     while (text[length] != '\0') {
@@ -37,43 +40,6 @@ static int string_length(const char* text) {
     return length;
 }
 
-static const Glyph* find_glyph(char ch) {
-    for (u32 i = 0; i < (sizeof(kGlyphs) / sizeof(kGlyphs[0])); i++) {
-        if (kGlyphs[i].ch == ch) {
-            return &kGlyphs[i];
-        }
-    }
-    return &kGlyphs[0];
-}
-
-static void draw_pixel(int x, int y, u16 color) {
-    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) {
-        return;
-    }
-    volatile u16* fb = (volatile u16*)VDP2_VRAM;
-    fb[y * BITMAP_WIDTH + x] = color;
-}
-
-static void draw_glyph(int x, int y, const Glyph* glyph, u16 color) {
-    for (int row = 0; row < FONT_HEIGHT; row++) {
-        u8 bits = glyph->rows[row];
-        for (int col = 0; col < FONT_WIDTH; col++) {
-            if (bits & (0x80 >> col)) {
-                draw_pixel(x + col, y + row, color);
-            }
-        }
-    }
-}
-
-static void draw_text(int x, int y, const char* text, u16 color) {
-    int cursor = 0;
-    while (text[cursor] != '\0') {
-        draw_glyph(x, y, find_glyph(text[cursor]), color);
-        x += FONT_WIDTH + FONT_SPACING;
-        cursor++;
-    }
-}
-
 static void app_slave_main(void) {
     while (1) {
     }
@@ -81,19 +47,31 @@ static void app_slave_main(void) {
 
 static void app_main(void) {
     const char* message = "HELLO WORLD!";
-    int message_width = string_length(message) * (FONT_WIDTH + FONT_SPACING) - FONT_SPACING;
-    int start_x = (SCREEN_WIDTH - message_width) / 2;
-    int start_y = (SCREEN_HEIGHT - FONT_HEIGHT) / 2;
+    int start_x = (TEXT_COLUMNS - string_length(message)) / 2;
+    int start_y = TEXT_ROWS / 2;
 
     system_init();
     vdp1_init();
     vdp2_init();
+    dma_init();
+    dmac_init();
+    upload_init(UPLOAD_VBLANK_BUDGET);
+    interrupt_set_scu_handler(SCU_IRQ_VBLANK_IN, upload_vblank);
+    interrupt_enable_scu(SCU_IRQ_VBLANK_IN);
 
     vdp1_clear_screen(0x0000);
-    draw_text(start_x, start_y, message, 0x7FFF);
+
+    palette_init();
+    palette_set(1, 0x7FFF);
+    text_init(&kTextConfig);
+    text_load_glyphs(kGlyphs, sizeof(kGlyphs) / sizeof(kGlyphs[0]));
+    text_print(start_x, start_y, message);
 
     while (1) {
+        text_upload();
+        palette_upload();
         vdp2_wait_for_vblank();
+        vdp2_commit();
     }
 }
 
@@ -0,0 +1,198 @@
+#include "saturn/types.h"
+#include "saturn/system.h"
+#include "saturn/vdp1.h"
+#include "saturn/vdp2.h"
+#include "saturn/dma.h"
+#include "saturn/shared.h"
+#include "saturn/text.h"
+#include "saturn/palette.h"
+#include "saturn/upload.h"
+#include "saturn/dmac.h"
+#include "saturn/memory.h"
+#include "saturn/hardware.h"
+#include "config.h"
+
+#define BENCH_SIZES    10
+#define BENCH_MIN_SIZE 32
+#define BENCH_MAX_SIZE (BENCH_MIN_SIZE << (BENCH_SIZES - 1))
+#define BENCH_VRAM     (VDP2_VRAM + 0x60000)
+
+// FRT clocked at phi/32.
+#define FRT_CLOCK_DIV32 0x01
+
+enum {
+    COL_COPY_CPU,
+    COL_COPY_DMAC,
+    COL_VRAM_CPU,
+    COL_VRAM_DMAC,
+    COL_VRAM_SCU,
+    COL_SET_CPU,
+    COL_SET_DMAC,
+    COL_COUNT
+};
+
+static const TextGlyph kGlyphs[] = {
+    { ' ', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+    { '0', { 0x3C, 0x66, 0x6E, 0x76, 0x66, 0x66, 0x3C, 0x00 } },
+    { '1', { 0x18, 0x38, 0x18, 0x18, 0x18, 0x18, 0x7E, 0x00 } },
+    { '2', { 0x3C, 0x66, 0x06, 0x0C, 0x30, 0x60, 0x7E, 0x00 } },
+    { '3', { 0x3C, 0x66, 0x06, 0x1C, 0x06, 0x66, 0x3C, 0x00 } },
+    { '4', { 0x0C, 0x1C, 0x3C, 0x6C, 0x7E, 0x0C, 0x0C, 0x00 } },
+    { '5', { 0x7E, 0x60, 0x7C, 0x06, 0x06, 0x66, 0x3C, 0x00 } },
+    { '6', { 0x3C, 0x60, 0x7C, 0x66, 0x66, 0x66, 0x3C, 0x00 } },
+    { '7', { 0x7E, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x00 } },
+    { '8', { 0x3C, 0x66, 0x66, 0x3C, 0x66, 0x66, 0x3C, 0x00 } },
+    { '9', { 0x3C, 0x66, 0x66, 0x3E, 0x06, 0x0C, 0x38, 0x00 } },
+    { 'A', { 0x18, 0x3C, 0x66, 0x66, 0x7E, 0x66, 0x66, 0x00 } },
+    { 'C', { 0x3C, 0x66, 0x60, 0x60, 0x60, 0x66, 0x3C, 0x00 } },
+    { 'D', { 0x78, 0x6C, 0x66, 0x66, 0x66, 0x6C, 0x78, 0x00 } },
+    { 'E', { 0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x7E, 0x00 } },
+    { 'I', { 0x3C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, 0x00 } },
+    { 'M', { 0x63, 0x77, 0x7F, 0x6B, 0x63, 0x63, 0x63, 0x00 } },
+    { 'O', { 0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x00 } },
+    { 'P', { 0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0x00 } },
+    { 'R', { 0x7C, 0x66, 0x66, 0x7C, 0x6C, 0x66, 0x66, 0x00 } },
+    { 'S', { 0x3C, 0x66, 0x60, 0x3C, 0x06, 0x66, 0x3C, 0x00 } },
+    { 'T', { 0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00 } },
+    { 'U', { 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x00 } },
+    { 'V', { 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x18, 0x00 } },
+    { 'X', { 0x66, 0x66, 0x3C, 0x18, 0x3C, 0x66, 0x66, 0x00 } },
+    { 'Y', { 0x66, 0x66, 0x66, 0x3C, 0x18, 0x18, 0x18, 0x00 } },
+    { 'Z', { 0x7E, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E, 0x00 } },
+};
+
+static const TextConfig kTextConfig = {
+    .layer = BG_NBG1,
+    .char_addr = 0x40000,
+    .map_addr = 0x42000,
+    .palette = 0,
+    .priority = 7,
+};
+
+static u8 src_buf[BENCH_MAX_SIZE] ALIGN16;
+static u8 dst_buf[BENCH_MAX_SIZE] ALIGN16;
+static u32 ticks[BENCH_SIZES][COL_COUNT];
+
+static void timer_reset(void) {
+    SH2_TCR = FRT_CLOCK_DIV32;
+    SH2_FRCH = 0;
+    SH2_FRCL = 0;
+}
+
+static u32 timer_read(void) {
+    u32 hi = SH2_FRCH;
+    return (hi << 8) | SH2_FRCL;
+}
+
+static u32 time_copy(void* dst, const void* src, u32 size, MemPath path) {
+    sat_memcpy_path(dst, src, size, path);
+    timer_reset();
+    sat_memcpy_path(dst, src, size, path);
+    return timer_read();
+}
+
+static u32 time_set(void* dst, u32 size, MemPath path) {
+    sat_memset32_path(dst, 0, size, path);
+    timer_reset();
+    sat_memset32_path(dst, 0, size, path);
+    return timer_read();
+}
+
+static void run_benchmarks(void) {
+    for (u32 i = 0; i < BENCH_MAX_SIZE; i++) {
+        src_buf[i] = (u8)i;
+    }
+
+    for (u32 i = 0; i < BENCH_SIZES; i++) {
+        u32 size = BENCH_MIN_SIZE << i;
+        void* vram = (void*)BENCH_VRAM;
+
+        ticks[i][COL_COPY_CPU] = time_copy(dst_buf, src_buf, size, MEM_PATH_CPU);
+        ticks[i][COL_COPY_DMAC] = time_copy(dst_buf, src_buf, size, MEM_PATH_DMAC);
+        ticks[i][COL_VRAM_CPU] = time_copy(vram, src_buf, size, MEM_PATH_CPU);
+        ticks[i][COL_VRAM_DMAC] = time_copy(vram, src_buf, size, MEM_PATH_DMAC);
+        ticks[i][COL_VRAM_SCU] = time_copy(vram, src_buf, size, MEM_PATH_SCU);
+        ticks[i][COL_SET_CPU] = time_set(dst_buf, size, MEM_PATH_CPU);
+        ticks[i][COL_SET_DMAC] = time_set(dst_buf, size, MEM_PATH_DMAC);
+    }
+}
+
+// First size from which the DMA column stays faster than the CPU one.
+static u32 crossover(u32 cpu_col, u32 dma_col) {
+    u32 found = 0;
+
+    for (u32 i = BENCH_SIZES; i-- > 0;) {
+        if (ticks[i][dma_col] >= ticks[i][cpu_col]) {
+            break;
+        }
+        found = BENCH_MIN_SIZE << i;
+    }
+    return found;
+}
+
+static void print_results(void) {
+    text_print(0, 1, "SIZE COPY      VRAM           SET");
+    text_print(0, 2, "       CPU  DMA  CPU  DMA  SCU  CPU  DMA");
+
+    for (u32 i = 0; i < BENCH_SIZES; i++) {
+        text_printf(0, 4 + i, "%5u", BENCH_MIN_SIZE << i);
+        for (u32 col = 0; col < COL_COUNT; col++) {
+            text_printf(5 + col * 5, 4 + i, "%5u", ticks[i][col]);
+        }
+    }
+
+    text_print(0, 16, "CROSSOVER");
+    text_printf(0, 18, "COPY DMAC %5u", crossover(COL_COPY_CPU, COL_COPY_DMAC));
+    text_printf(0, 19, "VRAM DMAC %5u", crossover(COL_VRAM_CPU, COL_VRAM_DMAC));
+    text_printf(0, 20, "VRAM SCU  %5u", crossover(COL_VRAM_DMAC, COL_VRAM_SCU));
+    text_printf(0, 21, "SET  DMAC %5u", crossover(COL_SET_CPU, COL_SET_DMAC));
+}
+
+static void app_slave_main(void) {
+    while (1) {
+    }
+}
+
+static void app_main(void) {
+    system_init();
+    vdp1_init();
+    vdp2_init();
+    dma_init();
+    dmac_init();
+    upload_init(UPLOAD_VBLANK_BUDGET);
+    interrupt_set_scu_handler(SCU_IRQ_VBLANK_IN, upload_vblank);
+    interrupt_enable_scu(SCU_IRQ_VBLANK_IN);
+
+    vdp1_clear_screen(0x0000);
+
+    palette_init();
+    palette_set(1, 0x7FFF);
+    text_init(&kTextConfig);
+    text_load_glyphs(kGlyphs, sizeof(kGlyphs) / sizeof(kGlyphs[0]));
+
+    run_benchmarks();
+    print_results();
+
+    while (1) {
+        text_upload();
+        palette_upload();
+        vdp2_wait_for_vblank();
+        vdp2_commit();
+    }
+}
+
+void slave_main(void) {
+    app_slave_main();
+}
+
+void _slave_main(void) {
+    app_slave_main();
+}
+
+void main(void) {
+    app_main();
+}
+
+void _main(void) {
+    app_main();
+}
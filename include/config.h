@@ -1,6 +1,7 @@
 #ifndef SATURN_CONFIG_H
 #define SATURN_CONFIG_H
 
+// Boot display mode; display_set_mode() changes it at runtime.
 #define SCREEN_WIDTH  320
 #define SCREEN_HEIGHT 224
 
@@ -10,6 +11,39 @@
 
 #define MAX_VDP1_CMDS 1024
 
+// Frame pipeline, see saturn/pipeline.h.
+#define PIPELINE_MAX_MESHES 32
+#define PIPELINE_LIST_CMDS  MAX_VDP1_CMDS
+
+#define DMA_QUEUE_DEPTH 32
+#define DMAC_QUEUE_DEPTH 16
+
+// Set DMA_TRACE to 1 to log queued transfers, see saturn/dmatrace.h.
+// DMA_TRACE_ENTRIES must be a power of two.
+#define DMA_TRACE 0
+#define DMA_TRACE_ENTRIES 64
+
+// Set CPU_PROFILE to 1 to log job, idle and wait intervals on both
+// CPUs, see saturn/cpuprof.h. CPU_PROFILE_ENTRIES must be a power of two.
+#define CPU_PROFILE 0
+#define CPU_PROFILE_ENTRIES 64
+
+// Set to 1 in debug builds to count lock contention and seqlock
+// retries, see saturn/atomic.h.
+#define ATOMIC_STATS 0
+
+// Slots in the slave job ring, must be a power of two.
+#define JOB_QUEUE_DEPTH 32
+
+#define UPLOAD_QUEUE_DEPTH   64
+#define UPLOAD_TABLE_ENTRIES 32
+#define UPLOAD_VBLANK_BUDGET 0x4000
+
+// Crossover sizes in bytes, see examples/memcpy_bench.
+#define MEMCPY_DMA_THRESHOLD 512
+#define MEMCPY_SCU_THRESHOLD 2048
+#define MEMSET_DMA_THRESHOLD 1024
+
 #define MAX_QUADS 128
 #define MAX_VERTICES 256
 
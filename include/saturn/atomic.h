@@ -0,0 +1,136 @@
+#ifndef SATURN_ATOMIC_H
+#define SATURN_ATOMIC_H
+
+#include "saturn/types.h"
+#include "config.h"
+
+// Objects in this section are linked at uncached addresses, so every
+// access from either CPU goes to memory. The section is zeroed at
+// startup and initializers are ignored.
+#define SAT_UNCACHED SECTION(".uncached")
+
+#define atomic_barrier() __asm__ volatile ("" ::: "memory")
+
+// TAS.B locks the bus for its read-modify-write, so it is atomic across
+// both CPUs, but only on an uncached address. True if the byte was 0;
+// it is 0x80 afterwards either way.
+static inline bool atomic_test_and_set(volatile u8* p) {
+    u32 t;
+    __asm__ volatile ("tas.b @%1\n\tmovt %0" : "=r"(t) : "r"(p) : "t", "memory");
+    return t;
+}
+
+static inline void atomic_clear(volatile u8* p) {
+    atomic_barrier();
+    *p = 0;
+}
+
+// Locks must be in SAT_UNCACHED memory or be accessed through
+// UNCACHED(). They do not mask interrupts; a lock also taken by an
+// interrupt handler must be held with interrupts disabled.
+typedef struct {
+    volatile u8 locked;
+#if ATOMIC_STATS
+    u32 acquired;
+    u32 contended;
+    u32 spins;
+#endif
+} SpinLock;
+
+static inline bool spin_trylock(SpinLock* lock) {
+    if (!atomic_test_and_set(&lock->locked)) {
+        return false;
+    }
+#if ATOMIC_STATS
+    lock->acquired++;
+#endif
+    return true;
+}
+
+// Waits with plain reads so the bus is only locked when the lock looks
+// free.
+static inline void spin_lock(SpinLock* lock) {
+    u32 spins = 0;
+
+    while (!atomic_test_and_set(&lock->locked)) {
+        while (lock->locked) {
+            spins++;
+        }
+    }
+#if ATOMIC_STATS
+    lock->acquired++;
+    if (spins) {
+        lock->contended++;
+        lock->spins += spins;
+    }
+#else
+    (void)spins;
+#endif
+}
+
+static inline void spin_unlock(SpinLock* lock) {
+    atomic_clear(&lock->locked);
+}
+
+// SH-2 has no compare-and-swap, so counters shared by both CPUs take a
+// lock. Returns the new value.
+typedef struct {
+    SpinLock lock;
+    volatile u32 value;
+} AtomicCounter;
+
+static inline u32 atomic_add(AtomicCounter* counter, s32 delta) {
+    u32 value;
+
+    spin_lock(&counter->lock);
+    value = counter->value + delta;
+    counter->value = value;
+    spin_unlock(&counter->lock);
+    return value;
+}
+
+static inline u32 atomic_read(const AtomicCounter* counter) {
+    return counter->value;
+}
+
+// Sequence lock for data with one writer: readers never block it and
+// retry if it wrote in the meantime. The sequence is odd while a write
+// is in progress. The protected data has to be read uncached too.
+typedef struct {
+    volatile u32 seq;
+#if ATOMIC_STATS
+    u32 retries;
+#endif
+} SeqLock;
+
+static inline void seq_write_begin(SeqLock* lock) {
+    lock->seq++;
+    atomic_barrier();
+}
+
+static inline void seq_write_end(SeqLock* lock) {
+    atomic_barrier();
+    lock->seq++;
+}
+
+static inline u32 seq_read_begin(const SeqLock* lock) {
+    u32 seq;
+
+    while ((seq = lock->seq) & 1);
+    atomic_barrier();
+    return seq;
+}
+
+// The retry count is only kept exactly when one CPU reads.
+static inline bool seq_read_retry(SeqLock* lock, u32 seq) {
+    atomic_barrier();
+    if (lock->seq == seq) {
+        return false;
+    }
+#if ATOMIC_STATS
+    lock->retries++;
+#endif
+    return true;
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SATURN_CACHE_H
+#define SATURN_CACHE_H
+
+#include "saturn/types.h"
+
+#define CACHE_LINE_SIZE 16
+#define CACHE_SIZE      0x1000
+
+// In CACHE_MODE_2WAY_RAM ways 2 and 3 become 2 KB of RAM at
+// CACHE_ONCHIP_RAM, and the cache halves. crt0 starts both CPUs in this
+// mode when the program has SAT_ONCHIP sections.
+#define CACHE_ONCHIP_RAM      0xC0000000
+#define CACHE_ONCHIP_RAM_SIZE 0x800
+
+typedef enum {
+    CACHE_MODE_4WAY = 0,
+    CACHE_MODE_2WAY_RAM
+} CacheMode;
+
+// Each SH-2 has its own cache and these only act on the calling CPU's.
+// The cache is write-through, so writes are in memory when the store
+// completes; what goes stale is lines the other CPU or DMA wrote
+// behind it. See dualcpu_publish() for purging the other CPU.
+void cache_enable(void);
+void cache_disable(void);
+void cache_purge_all(void);
+
+// Drops the lines holding [addr, addr + size). Uncached addresses are
+// ignored, and large ranges fall back to a full purge.
+void cache_purge_range(const void* addr, u32 size);
+
+// Switching modes purges the cache; the on-chip RAM is not cleared but
+// is only reachable in CACHE_MODE_2WAY_RAM.
+void cache_set_mode(CacheMode mode);
+CacheMode cache_mode(void);
+
+#endif
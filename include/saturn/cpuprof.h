@@ -0,0 +1,76 @@
+#ifndef SATURN_CPUPROF_H
+#define SATURN_CPUPROF_H
+
+#include "saturn/types.h"
+#include "saturn/dualcpu.h"
+#include "config.h"
+
+typedef enum {
+    CPU_PROFILE_JOB = 0,
+    CPU_PROFILE_IDLE,
+    CPU_PROFILE_WAIT,
+    CPU_PROFILE_SLEEP,
+    CPU_PROFILE_EVENT_COUNT
+} CpuProfileEvent;
+
+// Times are FRT ticks of the CPU that logged them, extended to 32 bits;
+// see frt.h. The two CPUs' clocks run at the same rate but are not
+// aligned.
+typedef struct {
+    u8 cpu;
+    u8 event;
+    u16 reserved;
+    u32 start;
+    u32 end;
+} CpuProfileEntry;
+
+// Idle is the slave waiting for jobs, wait is either CPU blocked on the
+// other, and sleep is the part of both spent in the sleep instruction.
+// Job time includes waits inside jobs. Intervals are counted in the
+// frame they end in.
+typedef struct {
+    u32 frame_ticks;
+    u32 ticks[CPU_PROFILE_EVENT_COUNT];
+    u32 jobs;
+} CpuProfileFrame;
+
+// Each CPU's log starts with this word, so the host can find it in a
+// WRAM dump: magic, head, tail, lost, then the bookkeeping and
+// CPU_PROFILE_ENTRIES CpuProfileEntry records, big-endian.
+#define CPU_PROFILE_MAGIC 0x50524F46
+
+#if CPU_PROFILE
+
+// Runs on each CPU; dualcpu_init() calls it.
+void cpu_profile_init(void);
+
+void cpu_profile_begin(CpuProfileEvent event);
+void cpu_profile_end(CpuProfileEvent event);
+
+// Master only: closes the frame for both CPUs.
+void cpu_profile_frame(void);
+const CpuProfileFrame* cpu_profile_last_frame(CpuId cpu);
+
+// Drains a CPU's log, oldest first; either CPU can read either log. A
+// full log drops new entries and counts them.
+u32 cpu_profile_read(CpuId cpu, CpuProfileEntry* entries, u32 max);
+u32 cpu_profile_lost(CpuId cpu);
+
+#else
+
+static inline void cpu_profile_init(void) {}
+static inline void cpu_profile_begin(CpuProfileEvent event) { (void)event; }
+static inline void cpu_profile_end(CpuProfileEvent event) { (void)event; }
+
+#endif
+
+static inline u32 cpu_profile_percent(const CpuProfileFrame* f, CpuProfileEvent event) {
+    return f->frame_ticks ? (u32)((u64)f->ticks[event] * 100 / f->frame_ticks) : 0;
+}
+
+static inline u32 cpu_profile_busy_percent(const CpuProfileFrame* f) {
+    u32 stalled = cpu_profile_percent(f, CPU_PROFILE_IDLE) + cpu_profile_percent(f, CPU_PROFILE_WAIT);
+    return stalled < 100 ? 100 - stalled : 0;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SATURN_DISPLAY_H
+#define SATURN_DISPLAY_H
+
+#include "saturn/types.h"
+
+typedef enum {
+    DISPLAY_WIDTH_320 = 0,
+    DISPLAY_WIDTH_352,
+    DISPLAY_WIDTH_640,
+    DISPLAY_WIDTH_704
+} DisplayWidth;
+
+typedef enum {
+    DISPLAY_LINES_224 = 0,
+    DISPLAY_LINES_240,
+    DISPLAY_LINES_256
+} DisplayLines;
+
+typedef enum {
+    DISPLAY_PROGRESSIVE = 0,
+    DISPLAY_INTERLACE_SINGLE = 2,
+    DISPLAY_INTERLACE_DOUBLE = 3
+} DisplayInterlace;
+
+typedef enum {
+    DISPLAY_NTSC = 0,
+    DISPLAY_PAL
+} DisplayStandard;
+
+typedef struct {
+    DisplayWidth width;
+    DisplayLines lines;
+    DisplayInterlace interlace;
+} DisplayMode;
+
+typedef struct {
+    u16 width;
+    u16 height;         // doubled in double-density interlace
+    u16 framerate;
+    DisplayStandard standard;
+    bool hires;
+    bool double_density;
+} DisplayInfo;
+
+// Applies to VDP2 on the next vdp2_commit() and to VDP1 immediately, so
+// call it during VBlank. Returns false for values outside the enums and
+// for 256 lines on NTSC.
+bool display_set_mode(const DisplayMode* mode);
+const DisplayInfo* display_info(void);
+// Points VDP1 at the field being drawn. Double-density interlace needs it
+// every field, so call it from the VBlank-in handler; otherwise it does
+// nothing.
+void display_field_update(void);
+
+static inline u16 display_width(void) {
+    return display_info()->width;
+}
+
+static inline u16 display_height(void) {
+    return display_info()->height;
+}
+
+#endif
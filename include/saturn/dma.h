@@ -43,9 +43,73 @@ typedef struct {
     u32 mode;
 } DmaTransfer;
 
+typedef struct {
+    u32 count;
+    u32 dest_addr;
+    u32 src_addr;
+} DmaIndirectEntry;
+
+typedef struct {
+    DmaIndirectEntry* entries;
+    u32 capacity;
+    u32 count;
+} DmaTable;
+
+typedef enum {
+    DMA_PRIORITY_LOW = 0,
+    DMA_PRIORITY_NORMAL,
+    DMA_PRIORITY_HIGH
+} DmaPriority;
+
+typedef enum {
+    DMA_REQ_DONE = 0,
+    DMA_REQ_QUEUED,
+    DMA_REQ_ACTIVE
+} DmaRequestStatus;
+
+typedef s32 DmaHandle;
+typedef void (*DmaCallback)(void* arg);
+
+#define DMA_INVALID_HANDLE (-1)
+
+#define DMA_INDIRECT_END 0x80000000
+
+// SCU priority of the level 0 DMA-end interrupt.
+#define DMA0_END_IRQ_LEVEL 5
+
+// The SCU reads indirect tables from WRAM-H and needs them aligned to
+// their size rounded up to a power of two.
+#define DMA_TABLE_ALIGNMENT(n) \
+    ((n) * 12 <= 16 ? 16 : (n) * 12 <= 32 ? 32 : (n) * 12 <= 64 ? 64 : \
+     (n) * 12 <= 128 ? 128 : (n) * 12 <= 256 ? 256 : (n) * 12 <= 512 ? 512 : \
+     (n) * 12 <= 1024 ? 1024 : (n) * 12 <= 2048 ? 2048 : 4096)
+#define DMA_TABLE_STORAGE(name, n) \
+    DmaIndirectEntry name[n] __attribute__((aligned(DMA_TABLE_ALIGNMENT(n))))
+
 void dma_init(void);
+// Level 0 moves up to 1 MB per transfer or table entry, levels 1 and 2
+// up to 4 KB. dma_transfer() returns nonzero without starting anything
+// when a size is zero or over the level's maximum.
+u32 dma_max_size(DmaChannel ch);
+bool dma_transfer_fits(DmaChannel ch, const DmaTransfer* t);
 u32 dma_transfer(DmaChannel ch, const DmaTransfer* t);
 void dma_wait(DmaChannel ch);
 void dma_wait_all(void);
 
+void dma_table_init(DmaTable* table, DmaIndirectEntry* storage, u32 capacity);
+void dma_table_reset(DmaTable* table);
+bool dma_table_append(DmaTable* table, const void* src, u32 dest, u32 size);
+u32 dma_table_start(DmaChannel ch, DmaTable* table);
+
+// Queued transfers start from the level's DMA-end interrupt; callbacks
+// run in interrupt context. Submitting a transfer that does not fit the
+// level returns DMA_INVALID_HANDLE.
+void dma_queue_init(void);
+DmaHandle dma_queue_submit(DmaChannel ch, const DmaTransfer* t, DmaPriority priority,
+                           DmaCallback callback, void* arg);
+bool dma_queue_cancel(DmaHandle handle);
+DmaRequestStatus dma_queue_status(DmaHandle handle);
+void dma_queue_wait(DmaHandle handle);
+u32 dma_queue_pending(DmaChannel ch);
+
 #endif
@@ -0,0 +1,39 @@
+#ifndef SATURN_DMAC_H
+#define SATURN_DMAC_H
+
+#include "saturn/types.h"
+#include "saturn/dma.h"
+
+typedef enum {
+    DMAC_CH0 = 0,
+    DMAC_CH1,
+    DMAC_CH_COUNT
+} DmacChannel;
+
+#define DMAC_FIXED_SRC 0x01
+#define DMAC_IRQ_LEVEL 6
+
+typedef struct {
+    u32 src_addr;
+    u32 dest_addr;
+    u32 size;
+    u32 flags;
+} DmacTransfer;
+
+// Each SH-2 has its own DMAC, so dmac_init() has to run on every CPU
+// that uses it and handles are only valid on the CPU that got them.
+// Addresses and size must be 4-byte aligned.
+void dmac_init(void);
+u32 dmac_transfer(DmacChannel ch, const DmacTransfer* t);
+bool dmac_busy(DmacChannel ch);
+void dmac_wait(DmacChannel ch);
+
+// Same semantics as the SCU queue in dma.h.
+DmaHandle dmac_queue_submit(DmacChannel ch, const DmacTransfer* t, DmaPriority priority,
+                            DmaCallback callback, void* arg);
+bool dmac_queue_cancel(DmaHandle handle);
+DmaRequestStatus dmac_queue_status(DmaHandle handle);
+void dmac_queue_wait(DmaHandle handle);
+u32 dmac_queue_pending(DmacChannel ch);
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SATURN_DMATRACE_H
+#define SATURN_DMATRACE_H
+
+#include "saturn/types.h"
+#include "saturn/dma.h"
+#include "saturn/dmac.h"
+#include "saturn/frt.h"
+#include "config.h"
+
+typedef enum {
+    DMA_REGION_OTHER = 0,
+    DMA_REGION_WRAM_L,
+    DMA_REGION_WRAM_H,
+    DMA_REGION_A_BUS,
+    DMA_REGION_SOUND,
+    DMA_REGION_VDP1_VRAM,
+    DMA_REGION_VDP1_FB,
+    DMA_REGION_VDP2_VRAM,
+    DMA_REGION_VDP2_CRAM,
+    DMA_REGION_COUNT
+} DmaRegion;
+
+typedef enum {
+    DMA_TRACE_SCU0 = 0,
+    DMA_TRACE_SCU1,
+    DMA_TRACE_SCU2,
+    DMA_TRACE_DMAC0,
+    DMA_TRACE_DMAC1,
+    DMA_TRACE_CHANNEL_COUNT
+} DmaTraceChannel;
+
+// Indirect SCU transfers carry the regions of their first table entry.
+#define DMA_TRACE_INDIRECT 0x01
+
+// Timestamps are FRT ticks, see frt.h.
+typedef struct {
+    u8 channel;
+    u8 src_region;
+    u8 dest_region;
+    u8 flags;
+    u32 size;
+    u16 enqueue_time;
+    u16 start_time;
+    u16 end_time;
+} DmaTraceEntry;
+
+typedef struct {
+    u32 bytes[DMA_REGION_COUNT][DMA_REGION_COUNT];
+    u32 channel_bytes[DMA_TRACE_CHANNEL_COUNT];
+    u32 busy_ticks[DMA_TRACE_CHANNEL_COUNT];
+    u32 transfers;
+    u32 frame_ticks;
+} DmaTraceFrame;
+
+DmaRegion dma_trace_region(u32 addr);
+const char* dma_trace_region_name(DmaRegion region);
+
+#if DMA_TRACE
+
+// Traces are per CPU, like the DMAC queues: each call works on the
+// trace of the CPU it runs on. SCU transfers are traced on the master.
+void dma_trace_init(void);
+
+// Closes the current frame; call once per frame, e.g. after vblank.
+void dma_trace_frame(void);
+const DmaTraceFrame* dma_trace_last_frame(void);
+
+// Copies out the oldest entries and removes them from the ring. Entries
+// overwritten before they were read are counted by dma_trace_lost().
+u32 dma_trace_read(DmaTraceEntry* entries, u32 max);
+u32 dma_trace_lost(void);
+
+static inline u16 dma_trace_now(void) {
+    return frt_read();
+}
+
+// Called by the queues from the end interrupt.
+void dma_trace_scu(DmaChannel ch, const DmaTransfer* t, u16 enqueue_time, u16 start_time);
+void dma_trace_dmac(DmacChannel ch, const DmacTransfer* t, u16 enqueue_time, u16 start_time);
+
+#else
+
+static inline void dma_trace_init(void) {}
+
+static inline u16 dma_trace_now(void) {
+    return 0;
+}
+
+static inline void dma_trace_scu(DmaChannel ch, const DmaTransfer* t, u16 enqueue_time, u16 start_time) {
+    (void)ch; (void)t; (void)enqueue_time; (void)start_time;
+}
+
+static inline void dma_trace_dmac(DmacChannel ch, const DmacTransfer* t, u16 enqueue_time, u16 start_time) {
+    (void)ch; (void)t; (void)enqueue_time; (void)start_time;
+}
+
+#endif
+
+#endif
@@ -4,39 +4,102 @@
 #include "saturn/types.h"
 #include "saturn/shared.h"
 
-typedef enum {
-    DSP_OP_NOP = 0,
-    DSP_OP_LOAD,
-    DSP_OP_STORE,
-    DSP_OP_MOV,
-    DSP_OP_ADD,
-    DSP_OP_SUB,
-    DSP_OP_MUL,
-    DSP_OP_MAC,
-    DSP_OP_AND,
-    DSP_OP_OR,
-    DSP_OP_XOR,
-    DSP_OP_NOT
-} DspOpCode;
+#define DSP_PROGRAM_SIZE 256
+#define DSP_BANK_SIZE    64
+#define DSP_BANK_COUNT   4
 
+// dsp_dma_read() runs a loader from the top of program RAM; programs
+// that use it must stay below DSP_LOADER_ADDR.
+#define DSP_LOADER_ADDR  0xFA
+
+#define DSP_FLAG_OVERFLOW 0x00080000
+#define DSP_FLAG_END      0x00040000
+#define DSP_FLAG_CARRY    0x00100000
+#define DSP_FLAG_ZERO     0x00200000
+#define DSP_FLAG_SIGN     0x00400000
+#define DSP_FLAG_DMA      0x00800000
+
+// Vertices per DSP block: one data RAM bank in, one out.
+#define DSP_TRANSFORM_BLOCK 21
+#define DSP_OUTCODE_BLOCK   20
+
+// Outcode bits, set when the vertex is outside that side of the volume.
+// AND of a primitive's outcodes non-zero: reject it; OR zero: draw it
+// unclipped.
+#define DSP_CLIP_LEFT   0x01
+#define DSP_CLIP_RIGHT  0x02
+#define DSP_CLIP_TOP    0x04
+#define DSP_CLIP_BOTTOM 0x08
+#define DSP_CLIP_NEAR   0x10
+#define DSP_CLIP_FAR    0x20
+
+// Outcode buffers are written a word at a time.
+#define DSP_OUTCODE_SIZE(count) (((count) + 3) & ~3u)
+
+typedef void (*DspCallback)(void* arg);
+
+// out[r] = m[r][0] * x + m[r][1] * y + m[r][2] * z + m[r][3]
+typedef struct {
+    fix16_t m[3][4];
+} DspMatrix;
+
+// Inclusive bounds on projected x, y and z.
 typedef struct {
-    u32 prog_addr;
-    u32 ram_addr;
-} DspRegs;
+    fix16_t min_x;
+    fix16_t max_x;
+    fix16_t min_y;
+    fix16_t max_y;
+    fix16_t near;
+    fix16_t far;
+} DspClipVolume;
 
+// Program and data RAM are only reachable from the CPU while the DSP
+// is stopped.
 void dsp_init(void);
 void dsp_reset(void);
 void dsp_start(void);
 void dsp_stop(void);
+void dsp_step(void);
+bool dsp_busy(void);
 void dsp_wait(void);
 
-void dsp_load_program(const u32* code, u32 size);
+// Reading the flags clears DSP_FLAG_END.
+u32 dsp_flags(void);
+
+// Called from the DSP end interrupt raised by ENDI.
+void dsp_set_end_callback(DspCallback callback, void* arg);
+
+void dsp_load_program(const u32* code, u32 count);
+void dsp_set_pc(u8 pc);
 void dsp_execute_program(void);
 
-void dsp_set_register(u8 reg, u32 value);
-u32 dsp_get_register(u8 reg);
+void dsp_write_data(u8 bank, u8 offset, const u32* data, u32 count);
+void dsp_read_data(u8 bank, u8 offset, u32* data, u32 count);
+
+// Starts a DSP DMA from src (4-byte aligned, not WRAM-L) into a
+// data RAM bank. Use dsp_wait() before touching the bank.
+void dsp_dma_read(u8 bank, u8 offset, const void* src, u32 count);
 
+// Stock programs run as jobs, one at a time, chained block by block
+// from the end interrupt; the callback runs in interrupt context.
+// Buffers must be in WRAM-H and left alone until the job completes.
+// Results are written behind the CPU cache, so read them through
+// UNCACHED() or purge the range first.
+bool dsp_transform_batch(const DspMatrix* matrix, const Vec3* src, Vec3* dst, u32 count,
+                         DspCallback callback, void* arg);
+
+// One outcode byte per vertex. dst must be 4-byte aligned with room for
+// DSP_OUTCODE_SIZE(count) bytes; volume is read when the job starts.
+bool dsp_outcode_batch(const DspClipVolume* volume, const Vec3* src, u8* dst, u32 count,
+                       DspCallback callback, void* arg);
+bool dsp_job_busy(void);
+void dsp_job_wait(void);
+
+void dsp_matrix_from_mat4(const Mat4* mat, DspMatrix* result);
 void dsp_matrix_mul(const Mat4* a, const Mat4* b, Mat4* result);
+
+// A single vertex is not worth a DSP round trip; this runs on the CPU.
 void dsp_vector_transform(const Vec3* vec, const Mat4* mat, Vec3* result);
+u8 dsp_outcode(const DspClipVolume* volume, const Vec3* vec);
 
 #endif
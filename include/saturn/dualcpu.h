@@ -2,12 +2,22 @@
 #define SATURN_DUALCPU_H
 
 #include "saturn/types.h"
+#include "saturn/hardware.h"
 
 typedef enum {
     CPU_MASTER = 0,
     CPU_SLAVE
 } CpuId;
 
+// BCR1 bit 15 reflects the MASTER pin of the CPU reading it.
+static inline CpuId dualcpu_current_cpu(void) {
+    return (SH2_BCR1 & 0x8000) ? CPU_SLAVE : CPU_MASTER;
+}
+
+// Sets up signaling on the calling CPU; run it on both, after
+// system_init(). Signals raise FRT input capture on the other CPU, and
+// a wait sleeps until the CPU's own signal arrives. Waits can return
+// early, so loop on the condition being waited for.
 void dualcpu_init(void);
 void dualcpu_start_slave(void);
 void dualcpu_stop_slave(void);
@@ -17,7 +27,18 @@ void dualcpu_signal_slave(void);
 void dualcpu_wait_for_slave(void);
 void dualcpu_wait_for_master(void);
 
+// Purge a CPU's cache; for the other CPU this is done from its signal
+// interrupt and the call sleeps until it signals back, so that CPU has
+// to have run dualcpu_init() and must not keep the FRT interrupt masked.
+// Purges the other CPU asks of the caller meanwhile are served. Size 0
+// purges the whole cache. The cache is write-through, so flushing is the
+// same as purging.
 void dualcpu_purge_cache(CpuId cpu);
+void dualcpu_purge_range(CpuId cpu, const void* addr, u32 size);
 void dualcpu_flush_cache(CpuId cpu);
 
+// Call after writing a shared buffer: the other CPU drops its stale
+// lines for it and can then read it cached.
+void dualcpu_publish(const void* addr, u32 size);
+
 #endif
@@ -4,11 +4,11 @@
 #include "saturn/types.h"
 
 static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
-    return (fix16_t)(((s64)a * (s64)b) >> 16);
+    return (fix16_t)(((s64)(s32)a * (s32)b) >> 16);
 }
 
 static inline fix16_t fix16_div(fix16_t a, fix16_t b) {
-    return (fix16_t)(((s64)a << 16) / b);
+    return (fix16_t)(((s64)(s32)a << 16) / (s32)b);
 }
 
 static inline fix16_t fix16_add(fix16_t a, fix16_t b) {
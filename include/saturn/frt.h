@@ -0,0 +1,46 @@
+#ifndef SATURN_FRT_H
+#define SATURN_FRT_H
+
+#include "saturn/types.h"
+#include "saturn/hardware.h"
+
+// Each SH-2 has its own free-running timer; counts from the two CPUs are
+// not comparable. At phi/32 a tick is about 1.2us and the 16-bit count
+// wraps every 78ms, so differences of u16 readings are valid up to that.
+#define FRT_CLOCK_DIV32 0x01
+
+// Vectors and level set up by system_init().
+#define FRT_VECTOR_ICI  0x64
+#define FRT_VECTOR_OCI  0x65
+#define FRT_IRQ_LEVEL   10
+
+#define FRT_TIER_ICIE   0x80
+#define FRT_TIER_OCIAE  0x08
+#define FRT_FTCSR_ICF   0x80
+#define FRT_FTCSR_OCFA  0x08
+#define FRT_FTCSR_CCLRA 0x01
+
+// Free-running: counter clear on compare match A off. Safe to call again
+// on a CPU whose timer is already running; pending flags are kept.
+static inline void frt_init(void) {
+    if (SH2_TCR == FRT_CLOCK_DIV32) {
+        return;
+    }
+    SH2_FTCSR &= ~FRT_FTCSR_CCLRA;
+    SH2_TCR = FRT_CLOCK_DIV32;
+}
+
+// FRCH must be read first; that latches FRCL.
+static inline u16 frt_read(void) {
+    u32 hi = SH2_FRCH;
+    return (u16)((hi << 8) | SH2_FRCL);
+}
+
+// Sets output compare A; its flag is raised when the count reaches it.
+static inline void frt_set_compare(u16 value) {
+    SH2_TOCR = 0xE0;
+    SH2_OCRH = value >> 8;
+    SH2_OCRL = value & 0xFF;
+}
+
+#endif
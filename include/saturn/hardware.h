@@ -28,15 +28,128 @@
 #define VDP2_CYCB1U    (*(volatile u16*)(VDP2_REGS + 0x001E))
 #define VDP2_BGON      (*(volatile u16*)(VDP2_REGS + 0x0020))
 #define VDP2_CHCTLA    (*(volatile u16*)(VDP2_REGS + 0x0028))
+#define VDP2_CHCTLB    (*(volatile u16*)(VDP2_REGS + 0x002A))
 #define VDP2_BMPNA     (*(volatile u16*)(VDP2_REGS + 0x002C))
+#define VDP2_BMPNB     (*(volatile u16*)(VDP2_REGS + 0x002E))
+#define VDP2_PNCN0     (*(volatile u16*)(VDP2_REGS + 0x0030))
+#define VDP2_PNCN1     (*(volatile u16*)(VDP2_REGS + 0x0032))
+#define VDP2_PNCN2     (*(volatile u16*)(VDP2_REGS + 0x0034))
+#define VDP2_PNCN3     (*(volatile u16*)(VDP2_REGS + 0x0036))
+#define VDP2_PNCR      (*(volatile u16*)(VDP2_REGS + 0x0038))
+#define VDP2_PLSZ      (*(volatile u16*)(VDP2_REGS + 0x003A))
 #define VDP2_MPOFN     (*(volatile u16*)(VDP2_REGS + 0x003C))
+#define VDP2_MPOFR     (*(volatile u16*)(VDP2_REGS + 0x003E))
+#define VDP2_MPABN0    (*(volatile u16*)(VDP2_REGS + 0x0040))
+#define VDP2_MPCDN0    (*(volatile u16*)(VDP2_REGS + 0x0042))
+#define VDP2_MPABN1    (*(volatile u16*)(VDP2_REGS + 0x0044))
+#define VDP2_MPCDN1    (*(volatile u16*)(VDP2_REGS + 0x0046))
+#define VDP2_MPABN2    (*(volatile u16*)(VDP2_REGS + 0x0048))
+#define VDP2_MPCDN2    (*(volatile u16*)(VDP2_REGS + 0x004A))
+#define VDP2_MPABN3    (*(volatile u16*)(VDP2_REGS + 0x004C))
+#define VDP2_MPCDN3    (*(volatile u16*)(VDP2_REGS + 0x004E))
+#define VDP2_SCXIN0    (*(volatile u16*)(VDP2_REGS + 0x0070))
+#define VDP2_SCYIN0    (*(volatile u16*)(VDP2_REGS + 0x0074))
+#define VDP2_SCXIN1    (*(volatile u16*)(VDP2_REGS + 0x0080))
+#define VDP2_SCYIN1    (*(volatile u16*)(VDP2_REGS + 0x0084))
+#define VDP2_SCXN2     (*(volatile u16*)(VDP2_REGS + 0x0090))
+#define VDP2_SCYN2     (*(volatile u16*)(VDP2_REGS + 0x0092))
+#define VDP2_SCXN3     (*(volatile u16*)(VDP2_REGS + 0x0094))
+#define VDP2_SCYN3     (*(volatile u16*)(VDP2_REGS + 0x0096))
+#define VDP2_LCTAU     (*(volatile u16*)(VDP2_REGS + 0x00A8))
+#define VDP2_LCTAL     (*(volatile u16*)(VDP2_REGS + 0x00AA))
+#define VDP2_BKTAU     (*(volatile u16*)(VDP2_REGS + 0x00AC))
+#define VDP2_BKTAL     (*(volatile u16*)(VDP2_REGS + 0x00AE))
+#define VDP2_RPMD      (*(volatile u16*)(VDP2_REGS + 0x00B0))
+#define VDP2_RPRCTL    (*(volatile u16*)(VDP2_REGS + 0x00B2))
+#define VDP2_KTCTL     (*(volatile u16*)(VDP2_REGS + 0x00B4))
+#define VDP2_KTAOF     (*(volatile u16*)(VDP2_REGS + 0x00B6))
+#define VDP2_RPTAU     (*(volatile u16*)(VDP2_REGS + 0x00BC))
+#define VDP2_RPTAL     (*(volatile u16*)(VDP2_REGS + 0x00BE))
+#define VDP2_WPSX0     (*(volatile u16*)(VDP2_REGS + 0x00C0))
+#define VDP2_WPSY0     (*(volatile u16*)(VDP2_REGS + 0x00C2))
+#define VDP2_WPEX0     (*(volatile u16*)(VDP2_REGS + 0x00C4))
+#define VDP2_WPEY0     (*(volatile u16*)(VDP2_REGS + 0x00C6))
+#define VDP2_WPSX1     (*(volatile u16*)(VDP2_REGS + 0x00C8))
+#define VDP2_WPSY1     (*(volatile u16*)(VDP2_REGS + 0x00CA))
+#define VDP2_WPEX1     (*(volatile u16*)(VDP2_REGS + 0x00CC))
+#define VDP2_WPEY1     (*(volatile u16*)(VDP2_REGS + 0x00CE))
+#define VDP2_WCTLA     (*(volatile u16*)(VDP2_REGS + 0x00D0))
+#define VDP2_WCTLB     (*(volatile u16*)(VDP2_REGS + 0x00D2))
+#define VDP2_WCTLC     (*(volatile u16*)(VDP2_REGS + 0x00D4))
+#define VDP2_WCTLD     (*(volatile u16*)(VDP2_REGS + 0x00D6))
+#define VDP2_LWTA0U    (*(volatile u16*)(VDP2_REGS + 0x00D8))
+#define VDP2_LWTA0L    (*(volatile u16*)(VDP2_REGS + 0x00DA))
+#define VDP2_LWTA1U    (*(volatile u16*)(VDP2_REGS + 0x00DC))
+#define VDP2_LWTA1L    (*(volatile u16*)(VDP2_REGS + 0x00DE))
+#define VDP2_SPCTL     (*(volatile u16*)(VDP2_REGS + 0x00E0))
+#define VDP2_SDCTL     (*(volatile u16*)(VDP2_REGS + 0x00E2))
+#define VDP2_CRAOFA    (*(volatile u16*)(VDP2_REGS + 0x00E4))
+#define VDP2_CRAOFB    (*(volatile u16*)(VDP2_REGS + 0x00E6))
+#define VDP2_LNCLEN    (*(volatile u16*)(VDP2_REGS + 0x00E8))
+#define VDP2_SFPRMD    (*(volatile u16*)(VDP2_REGS + 0x00EA))
+#define VDP2_CCCTL     (*(volatile u16*)(VDP2_REGS + 0x00EC))
+#define VDP2_SFCCMD    (*(volatile u16*)(VDP2_REGS + 0x00EE))
 #define VDP2_PRISA     (*(volatile u16*)(VDP2_REGS + 0x00F0))
+#define VDP2_PRISB     (*(volatile u16*)(VDP2_REGS + 0x00F2))
+#define VDP2_PRISC     (*(volatile u16*)(VDP2_REGS + 0x00F4))
+#define VDP2_PRISD     (*(volatile u16*)(VDP2_REGS + 0x00F6))
+#define VDP2_PRINA     (*(volatile u16*)(VDP2_REGS + 0x00F8))
+#define VDP2_PRINB     (*(volatile u16*)(VDP2_REGS + 0x00FA))
+#define VDP2_PRIR      (*(volatile u16*)(VDP2_REGS + 0x00FC))
+#define VDP2_CCRSA     (*(volatile u16*)(VDP2_REGS + 0x0100))
+#define VDP2_CCRSB     (*(volatile u16*)(VDP2_REGS + 0x0102))
+#define VDP2_CCRSC     (*(volatile u16*)(VDP2_REGS + 0x0104))
+#define VDP2_CCRSD     (*(volatile u16*)(VDP2_REGS + 0x0106))
+#define VDP2_CCRNA     (*(volatile u16*)(VDP2_REGS + 0x0108))
+#define VDP2_CCRNB     (*(volatile u16*)(VDP2_REGS + 0x010A))
+#define VDP2_CCRR      (*(volatile u16*)(VDP2_REGS + 0x010C))
+#define VDP2_CCRLB     (*(volatile u16*)(VDP2_REGS + 0x010E))
+#define VDP2_REGS_SIZE 0x0120
 #define VDP2_VRAM_SIZE 0x80000
+#define VDP2_VRAM_BANK_SIZE 0x20000
 
 #define SCU_REGS       0x25FE0000
-#define SCU_D0AD       (*(volatile u32*)0x25FE0080)
-#define SCU_D0EN       (*(volatile u32*)0x25FE0084)
-#define SCU_D0MD       (*(volatile u32*)0x25FE0088)
+#define SCU_DMA_REGS(level) ((volatile u32*)(SCU_REGS + (level) * 0x20))
+#define SCU_D0R        (*(volatile u32*)(SCU_REGS + 0x0000))
+#define SCU_D0W        (*(volatile u32*)(SCU_REGS + 0x0004))
+#define SCU_D0C        (*(volatile u32*)(SCU_REGS + 0x0008))
+#define SCU_D0AD       (*(volatile u32*)(SCU_REGS + 0x000C))
+#define SCU_D0EN       (*(volatile u32*)(SCU_REGS + 0x0010))
+#define SCU_D0MD       (*(volatile u32*)(SCU_REGS + 0x0014))
+#define SCU_DSTP       (*(volatile u32*)(SCU_REGS + 0x0060))
+#define SCU_DSTA       (*(volatile u32*)(SCU_REGS + 0x007C))
+#define SCU_PPAF       (*(volatile u32*)(SCU_REGS + 0x0080))
+#define SCU_PPD        (*(volatile u32*)(SCU_REGS + 0x0084))
+#define SCU_PDA        (*(volatile u32*)(SCU_REGS + 0x0088))
+#define SCU_PDD        (*(volatile u32*)(SCU_REGS + 0x008C))
+#define SCU_IMS        (*(volatile u32*)(SCU_REGS + 0x00A0))
+#define SCU_IST        (*(volatile u32*)(SCU_REGS + 0x00A4))
+
+#define SH2_REGS       0xFFFFFE00
+#define SH2_TIER       (*(volatile u8*)0xFFFFFE10)
+#define SH2_FTCSR      (*(volatile u8*)0xFFFFFE11)
+#define SH2_FRCH       (*(volatile u8*)0xFFFFFE12)
+#define SH2_FRCL       (*(volatile u8*)0xFFFFFE13)
+#define SH2_OCRH       (*(volatile u8*)0xFFFFFE14)
+#define SH2_OCRL       (*(volatile u8*)0xFFFFFE15)
+#define SH2_TCR        (*(volatile u8*)0xFFFFFE16)
+#define SH2_TOCR       (*(volatile u8*)0xFFFFFE17)
+#define SH2_IPRB       (*(volatile u16*)0xFFFFFE60)
+#define SH2_VCRC       (*(volatile u16*)0xFFFFFE66)
+#define SH2_IPRA       (*(volatile u16*)0xFFFFFEE2)
+#define SH2_CCR        (*(volatile u8*)0xFFFFFE92)
+#define SH2_DMAC_REGS(ch) ((volatile u32*)(0xFFFFFF80 + (ch) * 0x10))
+#define SH2_VCRDMA0    (*(volatile u32*)0xFFFFFFA0)
+#define SH2_VCRDMA1    (*(volatile u32*)0xFFFFFFA8)
+#define SH2_DMAOR      (*(volatile u32*)0xFFFFFFB0)
+#define SH2_BCR1       (*(volatile u32*)0xFFFFFFE0)
+
+#define SH2_CACHE_PURGE_AREA 0x40000000
+
+// A write to these raises FRT input capture on the slave and on the
+// master respectively.
+#define SH2_SIGNAL_SLAVE  (*(volatile u16*)0x21000000)
+#define SH2_SIGNAL_MASTER (*(volatile u16*)0x21800000)
 
 #define SMPC_REGS      0x26000000
 #define SMPC_COMREG    (*(volatile u8*)0x20100060)
@@ -0,0 +1,39 @@
+#ifndef SATURN_JOBS_H
+#define SATURN_JOBS_H
+
+#include "saturn/types.h"
+
+typedef void (*JobFunc)(void* arg);
+
+// done, if set, is written to 1 through the uncached mirror once func
+// has returned.
+typedef struct {
+    JobFunc func;
+    void* arg;
+    volatile u32* done;
+} Job;
+
+typedef u32 JobId;
+
+// Jobs run on the slave in submission order. The master is the only
+// producer and the slave the only consumer. The slave purges its cache
+// before each job, so arg data written by the master is seen; results
+// written by a job are in memory once it is done, but the master has to
+// read them uncached or purge its own cache first. Both sides sleep
+// while waiting; jobs_init() sets up signaling on the master.
+void jobs_init(void);
+
+// Both block while the ring is full. A batch is published in as few
+// pieces as the free space allows and returns the id of its last job.
+JobId job_submit(JobFunc func, void* arg, volatile u32* done);
+JobId job_submit_batch(const Job* jobs, u32 count);
+
+bool job_done(JobId id);
+void job_wait(JobId id);
+void job_wait_all(void);
+u32 job_pending(void);
+
+// Slave loop; call it from slave_main(). Never returns.
+void job_slave_loop(void);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SATURN_MEMORY_H
+#define SATURN_MEMORY_H
+
+#include "saturn/types.h"
+
+typedef enum {
+    MEM_PATH_AUTO = 0,
+    MEM_PATH_CPU,
+    MEM_PATH_DMAC,
+    MEM_PATH_SCU
+} MemPath;
+
+// Copies below MEMCPY_DMA_THRESHOLD run on the CPU. Larger ones go to
+// the SH-2 DMAC once dmac_init() has run on the calling CPU, or to SCU
+// DMA from the master CPU when one side is on the A/B-bus. Cached
+// destination lines are purged on the calling CPU after a DMA copy;
+// the other CPU has to purge its own cache. DMA waits for the end
+// interrupt, so with SR.I at or above DMAC_IRQ_LEVEL (or
+// DMA0_END_IRQ_LEVEL for SCU DMA), as in interrupt handlers and DMA
+// callbacks or before system_init(), the copy runs on the CPU.
+void* sat_memcpy(void* dst, const void* src, u32 size);
+void* sat_memset(void* dst, u8 value, u32 size);
+
+// dst must be 4-byte aligned; a trailing partial word gets the leading
+// bytes of the pattern. Picks a path the same way as sat_memcpy().
+void* sat_memset32(void* dst, u32 pattern, u32 size);
+
+// Forces a path, falling back to the CPU when it cannot handle the
+// arguments. Used by the benchmark example.
+void* sat_memcpy_path(void* dst, const void* src, u32 size, MemPath path);
+void* sat_memset32_path(void* dst, u32 pattern, u32 size, MemPath path);
+
+#endif
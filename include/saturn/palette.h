@@ -0,0 +1,23 @@
+#ifndef SATURN_PALETTE_H
+#define SATURN_PALETTE_H
+
+#include "saturn/types.h"
+
+#define PALETTE_SIZE      1024
+#define PALETTE_LEVEL_MAX 32
+
+// Entries are processed in pairs: first and count are rounded out to
+// even values. Results go to a WRAM copy that palette_upload() sends to
+// CRAM, which should happen during VBlank.
+void palette_init(void);
+void palette_load(u32 first, const color_t* colors, u32 count);
+void palette_set(u32 index, color_t color);
+void palette_restore(u32 first, u32 count);
+
+void palette_fade_to(u32 first, u32 count, color_t color, u32 level);
+void palette_crossfade(u32 first, u32 count, const color_t* target, u32 level);
+void palette_tint(u32 first, u32 count, u32 r, u32 g, u32 b);
+
+void palette_upload(void);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef SATURN_PARALLEL_H
+#define SATURN_PARALLEL_H
+
+#include "saturn/types.h"
+
+typedef void (*ParallelFunc)(u32 begin, u32 end, void* ctx);
+
+// Runs fn over [begin, end) on both CPUs and returns once all of it has
+// run. With grain 0 the range is split in halves, the master taking the
+// first. Otherwise both CPUs take grain-sized chunks from a shared
+// counter until it runs out, the master starting with the first one.
+//
+// The slave half goes through the job ring, so jobs_init() must have run
+// and the slave must be in job_slave_loop(). The slave purges its cache
+// before starting, and the master purges its own once the slave is done,
+// so output written by either CPU can be read normally afterwards.
+void sat_parallel_for(u32 begin, u32 end, u32 grain, ParallelFunc fn, void* ctx);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef SATURN_PIPELINE_H
+#define SATURN_PIPELINE_H
+
+#include "saturn/types.h"
+#include "saturn/shared.h"
+#include "config.h"
+
+typedef struct {
+    const Quad* quads;
+    u32 quad_count;
+    u16 color;
+    Mat4 model;
+} PipelineMesh;
+
+// Everything the slave needs to build one frame. The meshes' quads are
+// read by the slave while it builds, so they must stay valid until the
+// packet comes back from pipeline_begin_frame().
+typedef struct {
+    Mat4 view;
+    Mat4 projection;
+    u32 mesh_count;
+    PipelineMesh meshes[PIPELINE_MAX_MESHES];
+} FramePacket;
+
+// The master fills frame N+1's packet while the slave turns frame N's
+// into a VDP1 command list, as a job on the job ring. Finished lists are
+// shown at the next pipeline_vblank(), which the VBlank-in handler has
+// to call.
+//
+// Command slot 1 of VDP1 VRAM is a jump to the shown list, and three
+// lists of PIPELINE_LIST_CMDS commands follow it. Needs jobs_init() and
+// vdp1_set_resolution() first, and switches VDP1 to drawing on every
+// frame change.
+void pipeline_init(void);
+
+// Waits until the slave is done with the packet from two frames ago and
+// hands it back for filling.
+FramePacket* pipeline_begin_frame(void);
+// Waits until the previous frame's list is built and has been shown,
+// then queues this one. The build job itself never waits, so other jobs
+// queued after it are not held up.
+void pipeline_submit_frame(void);
+
+void pipeline_vblank(void);
+u32 pipeline_frames_shown(void);
+
+#endif
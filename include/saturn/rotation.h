@@ -0,0 +1,46 @@
+#ifndef SATURN_ROTATION_H
+#define SATURN_ROTATION_H
+
+#include "saturn/types.h"
+
+// One coefficient per display line, which covers double-density
+// interlace at 256 lines. Table B follows table A at this many entries.
+#define RBG0_MAX_LINES 512
+
+// VDP2 rotation parameter table layout (0x80 bytes, table B follows A).
+typedef struct {
+    s32 xst, yst, zst;
+    s32 dxst, dyst;
+    s32 dx, dy;
+    s32 a, b, c, d, e, f;
+    s16 px, py, pz, _pad0;
+    s16 cx, cy, cz, _pad1;
+    s32 mx, my;
+    s32 kx, ky;
+    u32 kast;
+    s32 dkast;
+    s32 dkax;
+    u32 _pad2[8];
+} PACKED Vdp2RotParams;
+
+typedef struct {
+    fix16_t x, y;       // position on the plane, in plane pixels
+    fix16_t height;     // eye height above the floor
+    fix16_t yaw;        // radians, 0 looks towards -Y on the plane
+    fix16_t pitch;      // radians, positive looks down
+    fix16_t distance;   // screen distance (focal length) in pixels
+} Rbg0Camera;
+
+typedef struct {
+    u32 param_addr;     // VDP2 VRAM offset of table A, 0x100 aligned
+    u32 coef_addr;      // VDP2 VRAM offset of the coefficient tables, 2KB each
+    u8 priority;
+    bool sky;           // draw lines above the horizon with table B
+    fix16_t sky_height; // ceiling height above the eye for table B
+} Rbg0Config;
+
+void rbg0_init(const Rbg0Config* config);
+void rbg0_set_camera(const Rbg0Camera* camera);
+void rbg0_upload(void);
+
+#endif
@@ -7,6 +7,7 @@
 #define UNCACHED(ptr) ((void*)((uint32_t)(ptr) | 0x20000000))
 #define VDP1_VRAM 0x25C00000
 #define VDP2_VRAM 0x25E00000
+#define VDP2_CRAM 0x25F00000
 
 typedef struct {
     volatile u32 state;
@@ -3,14 +3,78 @@
 
 #include "saturn/types.h"
 
+// Moves VBR to a table in WRAM on the calling CPU and unmasks
+// interrupts. Run it on each CPU; the default slave_main() does so for
+// the slave. Handlers can be installed before it, but only run once it
+// has lowered the mask.
 void system_init(void);
 void system_halt(void);
 
 void interrupt_enable_vblank(void);
 void interrupt_disable_vblank(void);
+
+// Sleeps until an interrupt arrives or about 1ms has passed, or returns
+// at once while the FRT interrupt is masked; loop on the condition being
+// waited for.
+void interrupt_sleep(void);
+
+// The master counts frames in its VBlank-in interrupt, which
+// system_init() enables. wait_frames(n) sleeps until n frames after the
+// previous wait returned; if that point has already passed, the excess
+// is counted as missed and it waits for the next vblank. The slave gets
+// no SCU interrupts, so there it polls VDP2 for n vblanks instead; so
+// does the master while VBlank-in is masked in SR or SCU IMS.
 void interrupt_wait_vblank(void);
+void wait_frames(u32 n);
+u32 system_frame_count(void);
+u32 system_missed_frames(void);
 
 typedef void (*InterruptHandler)(void);
 void interrupt_set_vblank_handler(InterruptHandler handler);
 
+// Handlers are plain C functions; the vector stubs save and restore
+// the caller-saved registers. Installs an SH-2 vector on the calling CPU.
+void interrupt_set_cpu_handler(u32 vector, InterruptHandler handler);
+
+typedef enum {
+    SCU_IRQ_VBLANK_IN = 0,
+    SCU_IRQ_VBLANK_OUT,
+    SCU_IRQ_HBLANK_IN,
+    SCU_IRQ_TIMER0,
+    SCU_IRQ_TIMER1,
+    SCU_IRQ_DSP_END,
+    SCU_IRQ_SOUND_REQUEST,
+    SCU_IRQ_SMPC,
+    SCU_IRQ_PAD,
+    SCU_IRQ_DMA2_END,
+    SCU_IRQ_DMA1_END,
+    SCU_IRQ_DMA0_END,
+    SCU_IRQ_DMA_ILLEGAL,
+    SCU_IRQ_SPRITE_END,
+    SCU_IRQ_COUNT
+} ScuIrq;
+
+// SCU interrupts only reach the master. The dispatcher clears the
+// source's IST bit before calling the handler.
+void interrupt_set_scu_handler(ScuIrq irq, InterruptHandler handler);
+void interrupt_enable_scu(ScuIrq irq);
+void interrupt_disable_scu(ScuIrq irq);
+
+static inline u32 interrupt_save_disable(void) {
+    u32 sr;
+    __asm__ volatile ("stc sr, %0" : "=r"(sr));
+    __asm__ volatile ("ldc %0, sr" : : "r"(sr | 0xF0) : "memory");
+    return sr;
+}
+
+static inline void interrupt_restore(u32 sr) {
+    __asm__ volatile ("ldc %0, sr" : : "r"(sr) : "memory");
+}
+
+static inline u32 interrupt_mask_level(void) {
+    u32 sr;
+    __asm__ volatile ("stc sr, %0" : "=r"(sr));
+    return (sr >> 4) & 0xF;
+}
+
 #endif
@@ -0,0 +1,40 @@
+#ifndef SATURN_TEXT_H
+#define SATURN_TEXT_H
+
+#include "saturn/types.h"
+#include "saturn/vdp2.h"
+
+#define TEXT_MAP_WIDTH  64
+#define TEXT_MAP_HEIGHT 32
+#define TEXT_MAX_GLYPHS 256
+
+typedef struct {
+    char ch;
+    u8 rows[8];
+} TextGlyph;
+
+typedef struct {
+    Vdp2BgLayer layer;  // BG_NBG0..BG_NBG3
+    u32 char_addr;      // VDP2 VRAM offset of the glyph cells, 0x2000 aligned
+    u32 map_addr;       // VDP2 VRAM offset of the 64x64 map, 0x2000 aligned
+    u8 palette;         // 16-color CRAM bank, glyph pixels use entry 1
+    u8 priority;
+} TextConfig;
+
+void text_init(const TextConfig* config);
+void text_load_font(const u8* rows, u8 first, u32 count);
+void text_load_glyphs(const TextGlyph* glyphs, u32 count);
+
+void text_clear(void);
+// Rows past the bottom wrap to the top, as a newline does; columns past
+// the right edge are clamped to it.
+void text_locate(u32 x, u32 y);
+void text_set_palette(u8 palette);
+void text_putc(char ch);
+void text_puts(const char* str);
+void text_print(u32 x, u32 y, const char* str);
+void text_printf(u32 x, u32 y, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+void text_upload(void);
+
+#endif
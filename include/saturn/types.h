@@ -31,7 +31,13 @@ typedef u32      fix16_t;
 #define ALIGN32  __attribute__((aligned(32)))
 
 #define PACKED  __attribute__((packed))
-#define SECTION(name) __attribute__((section(name))))
+#define SECTION(name) __attribute__((section(name)))
 #define NO_INLINE __attribute__((noinline))
 
+// Places code or data in the 2 KB of cache RAM, see saturn/cache.h.
+// Each CPU gets its own copy at startup, so writes to SAT_ONCHIP_DATA
+// stay on the CPU that made them.
+#define SAT_ONCHIP      SECTION(".onchip_text")
+#define SAT_ONCHIP_DATA SECTION(".onchip_data")
+
 #endif
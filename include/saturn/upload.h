@@ -0,0 +1,31 @@
+#ifndef SATURN_UPLOAD_H
+#define SATURN_UPLOAD_H
+
+#include "saturn/types.h"
+#include "saturn/dma.h"
+
+typedef struct {
+    u32 frame;
+    u32 bytes;          // bytes sent in the last VBlank
+    u32 transfers;      // chunks sent in the last VBlank
+    u32 carried;        // uploads left over after the last VBlank
+    u32 overflow_frames;
+    u32 missed_deadlines;
+    u32 busy_frames;    // VBlanks skipped because the last batch was still running
+    u32 dropped;        // submits refused because the queue was full
+} UploadStats;
+
+void upload_init(u32 vblank_budget);
+void upload_set_budget(u32 vblank_budget);
+
+// Deadline is in frames from now; 0 means the next VBlank. Submitting
+// the same src/dest pair again while pending updates the entry instead
+// of adding another one; it restarts from the beginning and keeps the
+// larger size. Uploads larger than the budget are split.
+bool upload_submit(const void* src, u32 dest, u32 size, DmaPriority priority, u32 deadline);
+
+// Call from the VBlank-IN handler.
+void upload_vblank(void);
+const UploadStats* upload_stats(void);
+
+#endif
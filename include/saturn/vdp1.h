@@ -25,6 +25,8 @@ typedef enum {
 } Vdp1ColorMode;
 
 void vdp1_init(void);
+void vdp1_set_resolution(u16 width, u16 height, bool hires, bool double_density);
+void vdp1_set_field(bool odd);
 void vdp1_wait_for_vblank(void);
 void vdp1_start_frame(void);
 void vdp1_end_frame(void);
@@ -21,6 +21,38 @@ typedef enum {
     BG_RBG1
 } Vdp2BgLayer;
 
+typedef enum {
+    VDP2_CC_RATIO_TOP = 0,
+    VDP2_CC_RATIO_SECOND,
+    VDP2_CC_ADD
+} Vdp2ColorCalcMode;
+
+typedef enum {
+    VDP2_WINDOW_0 = 0,
+    VDP2_WINDOW_1
+} Vdp2Window;
+
+typedef enum {
+    VDP2_WT_NBG0 = 0,
+    VDP2_WT_NBG1,
+    VDP2_WT_NBG2,
+    VDP2_WT_NBG3,
+    VDP2_WT_RBG0,
+    VDP2_WT_SPRITE,
+    VDP2_WT_ROTATION,
+    VDP2_WT_COLOR_CALC
+} Vdp2WindowTarget;
+
+#define VDP2_WIN_W0_OUTSIDE     0x01
+#define VDP2_WIN_W0             0x02
+#define VDP2_WIN_W1_OUTSIDE     0x04
+#define VDP2_WIN_W1             0x08
+#define VDP2_WIN_SPRITE_OUTSIDE 0x10
+#define VDP2_WIN_SPRITE         0x20
+#define VDP2_WIN_AND            0x80
+
+#define VDP2_LAYER_MASK(layer) (1 << (layer))
+
 typedef struct {
     u16 map_base;
     u16 char_base;
@@ -35,4 +67,29 @@ void vdp2_set_bg_config(Vdp2BgLayer layer, const Vdp2BgConfig* config);
 void vdp2_set_bg_scroll(Vdp2BgLayer layer, s16 x, s16 y);
 void vdp2_wait_for_vblank(void);
 
+void vdp2_set_priority(Vdp2BgLayer layer, u8 priority);
+void vdp2_set_sprite_type(u8 type);
+void vdp2_set_sprite_priority(u8 reg, u8 priority);
+
+void vdp2_set_color_calc_mode(Vdp2ColorCalcMode mode);
+void vdp2_set_color_calc(Vdp2BgLayer layer, bool enable, u8 ratio);
+void vdp2_set_sprite_color_calc(bool enable, u8 reg, u8 ratio);
+void vdp2_set_shadow(Vdp2BgLayer layer, bool enable);
+void vdp2_set_line_color(u32 table_addr, bool per_line, u16 layer_mask);
+
+void vdp2_set_window_rect(Vdp2Window window, s16 x1, s16 y1, s16 x2, s16 y2);
+void vdp2_set_line_window(Vdp2Window window, bool enable, u32 table_addr);
+void vdp2_set_window(Vdp2WindowTarget target, u8 flags);
+
+void vdp2_preset_translucent(Vdp2BgLayer layer, u8 ratio);
+void vdp2_preset_shadows(u16 layer_mask);
+void vdp2_preset_spotlight(u16 layer_mask, s16 x1, s16 y1, s16 x2, s16 y2);
+
+// Register writes land in a WRAM shadow and reach the VDP2 on the next
+// vdp2_commit(), which should run during VBlank.
+void vdp2_reg_write(volatile u16* reg, u16 value);
+void vdp2_reg_modify(volatile u16* reg, u16 mask, u16 value);
+u16 vdp2_reg_read(volatile u16* reg);
+void vdp2_commit(void);
+
 #endif
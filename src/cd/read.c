@@ -1,4 +1,5 @@
 #include "saturn/cd.h"
+#include "saturn/memory.h"
 #include "saturn/hardware.h"
 
 #define CDBLOCK_CMD_GET_STATUS 0x00
@@ -27,12 +28,7 @@ CdStatus cd_read_sector(u32 lba, void* dest) {
     if (cd_regs[0] & 0x2000) return CD_STATUS_ERROR;
     if (cd_regs[0] & 0x4000) return CD_STATUS_NO_DISC;
     
-    volatile u16* data = (volatile u16*)0x25E80000;
-    u16* d = (u16*)dest;
-    
-    for (int i = 0; i < CD_SECTOR_SIZE / 2; i++) {
-        d[i] = data[i];
-    }
+    sat_memcpy(dest, (const void*)0x25E80000, CD_SECTOR_SIZE);
     
     return CD_STATUS_OK;
 }
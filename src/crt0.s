@@ -16,6 +16,21 @@ clear_bss:
     cmp/ge r1, r0
     bf clear_bss
     
+    mov.l _uncached_start_ptr, r0
+    mov.l _uncached_end_ptr, r1
+    bra clear_uncached_test
+    nop
+clear_uncached:
+    mov.l r2, @r0
+    add #4, r0
+clear_uncached_test:
+    cmp/hs r1, r0
+    bf clear_uncached
+    
+    mov.l _onchip_setup_ptr, r0
+    jsr @r0
+    nop
+    
     mov.l _slave_start_ptr, r0
     mov.l r0, @r0
     
@@ -27,12 +42,42 @@ clear_bss:
 
 _slave_entry:
     mov.l _slave_stack_ptr, r15
+    mov.l _onchip_setup_ptr, r0
+    jsr @r0
+    nop
     mov.l _slave_main_ptr, r0
     jsr @r0
     nop
     bra _slave_entry
     nop
 
+! Each CPU has its own on-chip RAM, so both run this. Programs without
+! on-chip sections keep the full 4-way cache.
+_onchip_setup:
+    mov.l _onchip_start_ptr, r1
+    mov.l _onchip_end_ptr, r2
+    cmp/eq r1, r2
+    bt onchip_done
+    
+    mov.l _ccr_ptr, r3
+    mov #0, r0
+    mov.b r0, @r3
+    mov #0x18, r0
+    mov.b r0, @r3
+    mov #0x09, r0
+    mov.b r0, @r3
+    
+    mov.l _onchip_load_ptr, r0
+copy_onchip:
+    mov.l @r0+, r3
+    mov.l r3, @r1
+    add #4, r1
+    cmp/hs r2, r1
+    bf copy_onchip
+onchip_done:
+    rts
+    nop
+
 .align 4
 _master_stack_ptr: .long _master_stack
 _slave_stack_ptr:  .long _slave_stack
@@ -41,3 +86,10 @@ _slave_main_ptr:   .long _slave_main
 _bss_start:        .long _bss_start
 _bss_end:          .long _bss_end
 _slave_start_ptr:  .long _slave_start
+_onchip_setup_ptr: .long _onchip_setup
+_onchip_start_ptr: .long _onchip_start
+_onchip_end_ptr:   .long _onchip_end
+_onchip_load_ptr:  .long _onchip_load
+_ccr_ptr:          .long 0xFFFFFE92
+_uncached_start_ptr: .long _uncached_start
+_uncached_end_ptr:   .long _uncached_end
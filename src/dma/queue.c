@@ -0,0 +1,175 @@
+#include "saturn/dma.h"
+#include "saturn/dmatrace.h"
+#include "saturn/system.h"
+#include "config.h"
+
+typedef struct DmaRequest {
+    struct DmaRequest* next;
+    DmaTransfer transfer;
+    DmaCallback callback;
+    void* arg;
+    u8 channel;
+    u8 priority;
+    volatile u8 status;
+    u8 generation;
+    u16 enqueue_time;
+    u16 start_time;
+} DmaRequest;
+
+static DmaRequest pool[DMA_QUEUE_DEPTH];
+static DmaRequest* free_list;
+static DmaRequest* pending[DMA_CH_COUNT];
+static DmaRequest* active[DMA_CH_COUNT];
+static u32 pending_count[DMA_CH_COUNT];
+
+static inline DmaHandle make_handle(const DmaRequest* r) {
+    return (DmaHandle)(((u32)r->generation << 8) | (u32)(r - pool));
+}
+
+static DmaRequest* lookup(DmaHandle handle) {
+    u32 index = (u32)handle & 0xFF;
+    if (handle < 0 || index >= DMA_QUEUE_DEPTH) {
+        return 0;
+    }
+    DmaRequest* r = &pool[index];
+    if (r->generation != (u8)((u32)handle >> 8) || r->status == DMA_REQ_DONE) {
+        return 0;
+    }
+    return r;
+}
+
+static void release(DmaRequest* r) {
+    r->status = DMA_REQ_DONE;
+    r->generation++;
+    r->next = free_list;
+    free_list = r;
+}
+
+static void start_next(DmaChannel ch) {
+    DmaRequest* r = pending[ch];
+    if (r == 0 || active[ch] != 0) {
+        return;
+    }
+    pending[ch] = r->next;
+    pending_count[ch]--;
+    active[ch] = r;
+    r->status = DMA_REQ_ACTIVE;
+    r->start_time = dma_trace_now();
+    dma_transfer(ch, &r->transfer);
+}
+
+static void transfer_end(DmaChannel ch) {
+    DmaRequest* r = active[ch];
+
+    active[ch] = 0;
+    if (r) {
+        DmaCallback callback = r->callback;
+        void* arg = r->arg;
+        dma_trace_scu(ch, &r->transfer, r->enqueue_time, r->start_time);
+        release(r);
+        if (callback) {
+            callback(arg);
+        }
+    }
+    start_next(ch);
+}
+
+static void dma0_end_isr(void) {
+    transfer_end(DMA_CH0);
+}
+
+static void dma1_end_isr(void) {
+    transfer_end(DMA_CH1);
+}
+
+static void dma2_end_isr(void) {
+    transfer_end(DMA_CH2);
+}
+
+void dma_queue_init(void) {
+    free_list = 0;
+    for (int i = DMA_QUEUE_DEPTH - 1; i >= 0; i--) {
+        pool[i].status = DMA_REQ_DONE;
+        pool[i].next = free_list;
+        free_list = &pool[i];
+    }
+    for (int i = 0; i < DMA_CH_COUNT; i++) {
+        pending[i] = 0;
+        active[i] = 0;
+        pending_count[i] = 0;
+    }
+
+    interrupt_set_scu_handler(SCU_IRQ_DMA0_END, dma0_end_isr);
+    interrupt_set_scu_handler(SCU_IRQ_DMA1_END, dma1_end_isr);
+    interrupt_set_scu_handler(SCU_IRQ_DMA2_END, dma2_end_isr);
+    interrupt_enable_scu(SCU_IRQ_DMA0_END);
+    interrupt_enable_scu(SCU_IRQ_DMA1_END);
+    interrupt_enable_scu(SCU_IRQ_DMA2_END);
+}
+
+DmaHandle dma_queue_submit(DmaChannel ch, const DmaTransfer* t, DmaPriority priority,
+                           DmaCallback callback, void* arg) {
+    u32 sr = interrupt_save_disable();
+    DmaRequest* r = free_list;
+    DmaRequest** link;
+    DmaHandle handle;
+
+    if (r == 0 || !dma_transfer_fits(ch, t)) {
+        interrupt_restore(sr);
+        return DMA_INVALID_HANDLE;
+    }
+    free_list = r->next;
+
+    r->transfer = *t;
+    r->callback = callback;
+    r->arg = arg;
+    r->channel = (u8)ch;
+    r->priority = (u8)priority;
+    r->status = DMA_REQ_QUEUED;
+    r->enqueue_time = dma_trace_now();
+
+    // Keep FIFO order within a priority level.
+    link = &pending[ch];
+    while (*link && (*link)->priority >= priority) {
+        link = &(*link)->next;
+    }
+    r->next = *link;
+    *link = r;
+    pending_count[ch]++;
+
+    // The end interrupt may recycle r as soon as interrupts are back on.
+    handle = make_handle(r);
+    start_next(ch);
+    interrupt_restore(sr);
+    return handle;
+}
+
+bool dma_queue_cancel(DmaHandle handle) {
+    u32 sr = interrupt_save_disable();
+    DmaRequest* r = lookup(handle);
+    DmaRequest** link;
+
+    if (r == 0 || r->status != DMA_REQ_QUEUED) {
+        interrupt_restore(sr);
+        return false;
+    }
+    for (link = &pending[r->channel]; *link != r; link = &(*link)->next);
+    *link = r->next;
+    pending_count[r->channel]--;
+    release(r);
+    interrupt_restore(sr);
+    return true;
+}
+
+DmaRequestStatus dma_queue_status(DmaHandle handle) {
+    DmaRequest* r = lookup(handle);
+    return r ? (DmaRequestStatus)r->status : DMA_REQ_DONE;
+}
+
+void dma_queue_wait(DmaHandle handle) {
+    while (dma_queue_status(handle) != DMA_REQ_DONE);
+}
+
+u32 dma_queue_pending(DmaChannel ch) {
+    return pending_count[ch] + (active[ch] ? 1 : 0);
+}
@@ -1,24 +1,76 @@
 #include "saturn/dma.h"
+#include "saturn/dmatrace.h"
 #include "saturn/hardware.h"
 
+#define DMA_REG_R   0
+#define DMA_REG_W   1
+#define DMA_REG_C   2
+#define DMA_REG_AD  3
+#define DMA_REG_EN  4
+#define DMA_REG_MD  5
+
+#define DMA_AD_READ4_WRITE2 0x00000101
+#define DMA_EN_START        0x00000101
+#define DMA_MD_INDIRECT     0x01000000
+#define DMA_MD_FACTOR_EN    0x00000007
+
+// A count of zero in the register means the level's maximum.
+static const u32 dma_count_mask[DMA_CH_COUNT] = { 0x000FFFFF, 0x00000FFF, 0x00000FFF };
+
+static bool size_fits(DmaChannel ch, u32 size) {
+    return size != 0 && size <= dma_count_mask[ch] + 1;
+}
+
 void dma_init(void) {
-    SCU_D0EN = 0;
+    for (int i = 0; i < DMA_CH_COUNT; i++) {
+        SCU_DMA_REGS(i)[DMA_REG_EN] = 0;
+    }
+    dma_trace_init();
+    dma_queue_init();
+}
+
+u32 dma_max_size(DmaChannel ch) {
+    return dma_count_mask[ch] + 1;
+}
+
+bool dma_transfer_fits(DmaChannel ch, const DmaTransfer* t) {
+    if (t->mode == DMA_MODE_INDIRECT) {
+        const DmaIndirectEntry* e = (const DmaIndirectEntry*)t->src_addr;
+        do {
+            if (!size_fits(ch, e->count)) {
+                return false;
+            }
+        } while (!((e++)->src_addr & DMA_INDIRECT_END));
+        return true;
+    }
+    return size_fits(ch, t->size);
 }
 
 u32 dma_transfer(DmaChannel ch, const DmaTransfer* t) {
-    volatile u32* dmad = &SCU_D0AD + (ch * 4);
-    
-    dmad[0] = t->src_addr;
-    dmad[1] = t->dest_addr;
-    dmad[2] = t->size;
-    dmad[3] = 0x100 | (t->mode << 4);
-    
+    volatile u32* dmad = SCU_DMA_REGS(ch);
+
+    if (!dma_transfer_fits(ch, t)) {
+        return 1;
+    }
+
+    dmad[DMA_REG_EN] = 0;
+    dmad[DMA_REG_AD] = DMA_AD_READ4_WRITE2;
+    if (t->mode == DMA_MODE_INDIRECT) {
+        dmad[DMA_REG_W] = t->src_addr;
+        dmad[DMA_REG_MD] = DMA_MD_INDIRECT | DMA_MD_FACTOR_EN;
+    } else {
+        dmad[DMA_REG_R] = t->src_addr;
+        dmad[DMA_REG_W] = t->dest_addr;
+        dmad[DMA_REG_C] = t->size & dma_count_mask[ch];
+        dmad[DMA_REG_MD] = DMA_MD_FACTOR_EN;
+    }
+    dmad[DMA_REG_EN] = DMA_EN_START;
+
     return 0;
 }
 
 void dma_wait(DmaChannel ch) {
-    volatile u32* dmad = &SCU_D0EN + (ch * 4);
-    while (*dmad & 0x100);
+    while (SCU_DSTA & (0x10 << (ch * 4)));
 }
 
 void dma_wait_all(void) {
@@ -26,3 +78,44 @@ void dma_wait_all(void) {
         dma_wait(i);
     }
 }
+
+void dma_table_init(DmaTable* table, DmaIndirectEntry* storage, u32 capacity) {
+    table->entries = storage;
+    table->capacity = capacity;
+    table->count = 0;
+}
+
+void dma_table_reset(DmaTable* table) {
+    table->count = 0;
+}
+
+bool dma_table_append(DmaTable* table, const void* src, u32 dest, u32 size) {
+    DmaIndirectEntry* e;
+
+    if (table->count >= table->capacity || !size_fits(DMA_CH0, size)) {
+        return false;
+    }
+    if (table->count > 0) {
+        table->entries[table->count - 1].src_addr &= ~DMA_INDIRECT_END;
+    }
+
+    e = &table->entries[table->count++];
+    e->count = size;
+    e->dest_addr = dest;
+    e->src_addr = (u32)src | DMA_INDIRECT_END;
+    return true;
+}
+
+u32 dma_table_start(DmaChannel ch, DmaTable* table) {
+    DmaTransfer t;
+
+    if (table->count == 0) {
+        return 0;
+    }
+
+    t.src_addr = (u32)table->entries;
+    t.dest_addr = 0;
+    t.size = 0;
+    t.mode = DMA_MODE_INDIRECT;
+    return dma_transfer(ch, &t);
+}
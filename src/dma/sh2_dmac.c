@@ -0,0 +1,245 @@
+#include "saturn/dmac.h"
+#include "saturn/dmatrace.h"
+#include "saturn/dualcpu.h"
+#include "saturn/system.h"
+#include "saturn/hardware.h"
+#include "config.h"
+
+#define DMAC_SAR  0
+#define DMAC_DAR  1
+#define DMAC_TCR  2
+#define DMAC_CHCR 3
+
+#define CHCR_DEST_INC  0x4000
+#define CHCR_SRC_INC   0x1000
+#define CHCR_SIZE_LONG 0x0800
+#define CHCR_AUTO      0x0200
+#define CHCR_IE        0x0004
+#define CHCR_TE        0x0002
+#define CHCR_DE        0x0001
+
+#define DMAOR_PR  0x0008
+#define DMAOR_DME 0x0001
+
+#define DMAC_VECTOR_CH0 0x6C
+#define DMAC_VECTOR_CH1 0x6D
+#define IPRA_DMAC_MASK  0x0F00
+
+typedef struct DmacRequest {
+    struct DmacRequest* next;
+    DmacTransfer transfer;
+    DmaCallback callback;
+    void* arg;
+    u8 channel;
+    u8 priority;
+    volatile u8 status;
+    u8 generation;
+    u16 enqueue_time;
+    u16 start_time;
+} DmacRequest;
+
+typedef struct {
+    DmacRequest pool[DMAC_QUEUE_DEPTH];
+    DmacRequest* free_list;
+    DmacRequest* pending[DMAC_CH_COUNT];
+    DmacRequest* active[DMAC_CH_COUNT];
+    u32 pending_count[DMAC_CH_COUNT];
+} DmacQueue;
+
+// One queue per CPU; each is only touched by the CPU that owns it.
+static DmacQueue queues[2];
+
+static inline DmacQueue* local_queue(void) {
+    return &queues[dualcpu_current_cpu()];
+}
+
+static inline DmaHandle make_handle(const DmacQueue* q, const DmacRequest* r) {
+    return (DmaHandle)(((u32)r->generation << 8) | (u32)(r - q->pool));
+}
+
+static DmacRequest* lookup(DmacQueue* q, DmaHandle handle) {
+    u32 index = (u32)handle & 0xFF;
+    if (handle < 0 || index >= DMAC_QUEUE_DEPTH) {
+        return 0;
+    }
+    DmacRequest* r = &q->pool[index];
+    if (r->generation != (u8)((u32)handle >> 8) || r->status == DMA_REQ_DONE) {
+        return 0;
+    }
+    return r;
+}
+
+static void release(DmacQueue* q, DmacRequest* r) {
+    r->status = DMA_REQ_DONE;
+    r->generation++;
+    r->next = q->free_list;
+    q->free_list = r;
+}
+
+static void start(DmacChannel ch, const DmacTransfer* t, u32 irq) {
+    volatile u32* dmac = SH2_DMAC_REGS(ch);
+    u32 chcr = CHCR_DEST_INC | CHCR_SIZE_LONG | CHCR_AUTO | CHCR_DE | irq;
+
+    if (!(t->flags & DMAC_FIXED_SRC)) {
+        chcr |= CHCR_SRC_INC;
+    }
+
+    (void)dmac[DMAC_CHCR];
+    dmac[DMAC_CHCR] = 0;
+    dmac[DMAC_SAR] = t->src_addr;
+    dmac[DMAC_DAR] = t->dest_addr;
+    dmac[DMAC_TCR] = t->size >> 2;
+    dmac[DMAC_CHCR] = chcr;
+}
+
+static void start_next(DmacQueue* q, DmacChannel ch) {
+    DmacRequest* r = q->pending[ch];
+    if (r == 0 || q->active[ch] != 0) {
+        return;
+    }
+    q->pending[ch] = r->next;
+    q->pending_count[ch]--;
+    q->active[ch] = r;
+    r->status = DMA_REQ_ACTIVE;
+    r->start_time = dma_trace_now();
+    start(ch, &r->transfer, CHCR_IE);
+}
+
+static void transfer_end(DmacChannel ch) {
+    volatile u32* dmac = SH2_DMAC_REGS(ch);
+    DmacQueue* q = local_queue();
+    DmacRequest* r = q->active[ch];
+
+    (void)dmac[DMAC_CHCR];
+    dmac[DMAC_CHCR] = 0;
+
+    q->active[ch] = 0;
+    if (r) {
+        DmaCallback callback = r->callback;
+        void* arg = r->arg;
+        dma_trace_dmac(ch, &r->transfer, r->enqueue_time, r->start_time);
+        release(q, r);
+        if (callback) {
+            callback(arg);
+        }
+    }
+    start_next(q, ch);
+}
+
+static void dmac0_end_isr(void) {
+    transfer_end(DMAC_CH0);
+}
+
+static void dmac1_end_isr(void) {
+    transfer_end(DMAC_CH1);
+}
+
+void dmac_init(void) {
+    DmacQueue* q = local_queue();
+
+    for (int i = 0; i < DMAC_CH_COUNT; i++) {
+        volatile u32* dmac = SH2_DMAC_REGS(i);
+        (void)dmac[DMAC_CHCR];
+        dmac[DMAC_CHCR] = 0;
+        q->pending[i] = 0;
+        q->active[i] = 0;
+        q->pending_count[i] = 0;
+    }
+    q->free_list = 0;
+    for (int i = DMAC_QUEUE_DEPTH - 1; i >= 0; i--) {
+        q->pool[i].status = DMA_REQ_DONE;
+        q->pool[i].next = q->free_list;
+        q->free_list = &q->pool[i];
+    }
+
+    (void)SH2_DMAOR;
+    SH2_DMAOR = DMAOR_PR | DMAOR_DME;
+    SH2_VCRDMA0 = DMAC_VECTOR_CH0;
+    SH2_VCRDMA1 = DMAC_VECTOR_CH1;
+    SH2_IPRA = (SH2_IPRA & ~IPRA_DMAC_MASK) | (DMAC_IRQ_LEVEL << 8);
+    interrupt_set_cpu_handler(DMAC_VECTOR_CH0, dmac0_end_isr);
+    interrupt_set_cpu_handler(DMAC_VECTOR_CH1, dmac1_end_isr);
+    dma_trace_init();
+}
+
+u32 dmac_transfer(DmacChannel ch, const DmacTransfer* t) {
+    start(ch, t, 0);
+    return 0;
+}
+
+bool dmac_busy(DmacChannel ch) {
+    u32 chcr = SH2_DMAC_REGS(ch)[DMAC_CHCR];
+    return (chcr & CHCR_DE) && !(chcr & CHCR_TE);
+}
+
+void dmac_wait(DmacChannel ch) {
+    while (dmac_busy(ch));
+}
+
+DmaHandle dmac_queue_submit(DmacChannel ch, const DmacTransfer* t, DmaPriority priority,
+                            DmaCallback callback, void* arg) {
+    u32 sr = interrupt_save_disable();
+    DmacQueue* q = local_queue();
+    DmacRequest* r = q->free_list;
+    DmacRequest** link;
+    DmaHandle handle;
+
+    if (r == 0 || t->size < 4) {
+        interrupt_restore(sr);
+        return DMA_INVALID_HANDLE;
+    }
+    q->free_list = r->next;
+
+    r->transfer = *t;
+    r->callback = callback;
+    r->arg = arg;
+    r->channel = (u8)ch;
+    r->priority = (u8)priority;
+    r->status = DMA_REQ_QUEUED;
+    r->enqueue_time = dma_trace_now();
+
+    link = &q->pending[ch];
+    while (*link && (*link)->priority >= priority) {
+        link = &(*link)->next;
+    }
+    r->next = *link;
+    *link = r;
+    q->pending_count[ch]++;
+
+    handle = make_handle(q, r);
+    start_next(q, ch);
+    interrupt_restore(sr);
+    return handle;
+}
+
+bool dmac_queue_cancel(DmaHandle handle) {
+    u32 sr = interrupt_save_disable();
+    DmacQueue* q = local_queue();
+    DmacRequest* r = lookup(q, handle);
+    DmacRequest** link;
+
+    if (r == 0 || r->status != DMA_REQ_QUEUED) {
+        interrupt_restore(sr);
+        return false;
+    }
+    for (link = &q->pending[r->channel]; *link != r; link = &(*link)->next);
+    *link = r->next;
+    q->pending_count[r->channel]--;
+    release(q, r);
+    interrupt_restore(sr);
+    return true;
+}
+
+DmaRequestStatus dmac_queue_status(DmaHandle handle) {
+    DmacRequest* r = lookup(local_queue(), handle);
+    return r ? (DmaRequestStatus)r->status : DMA_REQ_DONE;
+}
+
+void dmac_queue_wait(DmaHandle handle) {
+    while (dmac_queue_status(handle) != DMA_REQ_DONE);
+}
+
+u32 dmac_queue_pending(DmacChannel ch) {
+    DmacQueue* q = local_queue();
+    return q->pending_count[ch] + (q->active[ch] ? 1 : 0);
+}
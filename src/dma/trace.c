@@ -0,0 +1,170 @@
+#include "saturn/dmatrace.h"
+#include "saturn/dualcpu.h"
+#include "saturn/system.h"
+
+DmaRegion dma_trace_region(u32 addr) {
+    u32 phys = addr & 0x07FFFFFF;
+
+    if ((addr >> 29) > 1) return DMA_REGION_OTHER;
+    if (phys >= 0x06000000) return DMA_REGION_WRAM_H;
+    if (phys >= 0x05F00000 && phys < 0x05F10000) return DMA_REGION_VDP2_CRAM;
+    if (phys >= 0x05E00000 && phys < 0x05F00000) return DMA_REGION_VDP2_VRAM;
+    if (phys >= 0x05C80000 && phys < 0x05CC0000) return DMA_REGION_VDP1_FB;
+    if (phys >= 0x05C00000 && phys < 0x05C80000) return DMA_REGION_VDP1_VRAM;
+    if (phys >= 0x05A00000 && phys < 0x05B00000) return DMA_REGION_SOUND;
+    if (phys >= 0x02000000 && phys < 0x05900000) return DMA_REGION_A_BUS;
+    if (phys >= 0x00200000 && phys < 0x00300000) return DMA_REGION_WRAM_L;
+    return DMA_REGION_OTHER;
+}
+
+static const char* const region_names[DMA_REGION_COUNT] = {
+    "OTHER", "WRAM-L", "WRAM-H", "A-BUS", "SOUND", "VDP1", "VDP1-FB", "VDP2", "CRAM"
+};
+
+const char* dma_trace_region_name(DmaRegion region) {
+    return region < DMA_REGION_COUNT ? region_names[region] : region_names[DMA_REGION_OTHER];
+}
+
+#if DMA_TRACE
+
+#define TRACE_MASK (DMA_TRACE_ENTRIES - 1)
+
+typedef struct {
+    DmaTraceEntry ring[DMA_TRACE_ENTRIES];
+    u32 head;
+    u32 tail;
+    u32 lost;
+    DmaTraceFrame frames[2];
+    u32 current;
+    u16 frame_start;
+} DmaTrace;
+
+static DmaTrace traces[2];
+
+static inline DmaTrace* local_trace(void) {
+    return &traces[dualcpu_current_cpu()];
+}
+
+static void clear_frame(DmaTraceFrame* f) {
+    u32* w = (u32*)f;
+
+    for (u32 i = 0; i < sizeof(*f) / 4; i++) {
+        w[i] = 0;
+    }
+}
+
+void dma_trace_init(void) {
+    DmaTrace* trace = local_trace();
+
+    frt_init();
+    trace->head = 0;
+    trace->tail = 0;
+    trace->lost = 0;
+    trace->current = 0;
+    clear_frame(&trace->frames[0]);
+    clear_frame(&trace->frames[1]);
+    trace->frame_start = frt_read();
+}
+
+void dma_trace_frame(void) {
+    u32 sr = interrupt_save_disable();
+    DmaTrace* trace = local_trace();
+    DmaTraceFrame* f = &trace->frames[trace->current];
+    u16 now = frt_read();
+
+    f->frame_ticks = (u16)(now - trace->frame_start);
+    trace->frame_start = now;
+    trace->current ^= 1;
+    clear_frame(&trace->frames[trace->current]);
+    interrupt_restore(sr);
+}
+
+const DmaTraceFrame* dma_trace_last_frame(void) {
+    DmaTrace* trace = local_trace();
+    return &trace->frames[trace->current ^ 1];
+}
+
+u32 dma_trace_read(DmaTraceEntry* entries, u32 max) {
+    u32 sr = interrupt_save_disable();
+    DmaTrace* trace = local_trace();
+    u32 count = 0;
+
+    while (count < max && trace->tail != trace->head) {
+        entries[count++] = trace->ring[trace->tail & TRACE_MASK];
+        trace->tail++;
+    }
+    interrupt_restore(sr);
+    return count;
+}
+
+u32 dma_trace_lost(void) {
+    return local_trace()->lost;
+}
+
+// Runs in the end interrupt, so the trace cannot change under it.
+static DmaTraceEntry* record(DmaTrace* trace, DmaTraceChannel ch, DmaRegion src, DmaRegion dest,
+                             u32 size, u16 enqueue_time, u16 start_time) {
+    DmaTraceFrame* f = &trace->frames[trace->current];
+    DmaTraceEntry* e;
+    u16 now = frt_read();
+
+    if (trace->head - trace->tail == DMA_TRACE_ENTRIES) {
+        trace->tail++;
+        trace->lost++;
+    }
+    e = &trace->ring[trace->head++ & TRACE_MASK];
+    e->channel = (u8)ch;
+    e->src_region = (u8)src;
+    e->dest_region = (u8)dest;
+    e->flags = 0;
+    e->size = size;
+    e->enqueue_time = enqueue_time;
+    e->start_time = start_time;
+    e->end_time = now;
+
+    f->channel_bytes[ch] += size;
+    f->busy_ticks[ch] += (u16)(now - start_time);
+    f->transfers++;
+    return e;
+}
+
+void dma_trace_scu(DmaChannel ch, const DmaTransfer* t, u16 enqueue_time, u16 start_time) {
+    DmaTrace* trace = local_trace();
+    DmaTraceFrame* f = &trace->frames[trace->current];
+    DmaRegion src = dma_trace_region(t->src_addr);
+    DmaRegion dest = dma_trace_region(t->dest_addr);
+    u32 size = t->size;
+    u8 flags = 0;
+
+    if (t->mode == DMA_MODE_INDIRECT) {
+        const DmaIndirectEntry* entry = (const DmaIndirectEntry*)t->src_addr;
+
+        src = dma_trace_region(entry->src_addr & ~DMA_INDIRECT_END);
+        dest = dma_trace_region(entry->dest_addr);
+        size = 0;
+        flags = DMA_TRACE_INDIRECT;
+        for (;; entry++) {
+            DmaRegion s = dma_trace_region(entry->src_addr & ~DMA_INDIRECT_END);
+            f->bytes[s][dma_trace_region(entry->dest_addr)] += entry->count;
+            size += entry->count;
+            if (entry->src_addr & DMA_INDIRECT_END) {
+                break;
+            }
+        }
+    } else {
+        f->bytes[src][dest] += size;
+    }
+
+    record(trace, DMA_TRACE_SCU0 + ch, src, dest, size, enqueue_time, start_time)->flags = flags;
+}
+
+void dma_trace_dmac(DmacChannel ch, const DmacTransfer* t, u16 enqueue_time, u16 start_time) {
+    DmaTrace* trace = local_trace();
+    DmaRegion src = dma_trace_region(t->src_addr);
+    DmaRegion dest = dma_trace_region(t->dest_addr);
+
+    trace->frames[trace->current].bytes[src][dest] += t->size;
+    record(trace, DMA_TRACE_DMAC0 + ch, src, dest, t->size, enqueue_time, start_time);
+}
+
+#endif
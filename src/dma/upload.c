@@ -0,0 +1,171 @@
+#include "saturn/upload.h"
+#include "saturn/system.h"
+#include "config.h"
+
+typedef struct UploadItem {
+    struct UploadItem* next;
+    u32 src;
+    u32 dest;
+    u32 size;
+    u32 sent;           // progress of a split upload
+    u32 deadline;
+    u8 priority;
+    bool late;
+} UploadItem;
+
+static UploadItem items[UPLOAD_QUEUE_DEPTH];
+static UploadItem* free_list;
+static UploadItem* pending;
+static DMA_TABLE_STORAGE(table_entries, UPLOAD_TABLE_ENTRIES);
+static DmaHandle batch = DMA_INVALID_HANDLE;
+static u32 budget = UPLOAD_VBLANK_BUDGET;
+static UploadStats stats;
+
+void upload_init(u32 vblank_budget) {
+    free_list = 0;
+    for (int i = UPLOAD_QUEUE_DEPTH - 1; i >= 0; i--) {
+        items[i].next = free_list;
+        free_list = &items[i];
+    }
+    pending = 0;
+    batch = DMA_INVALID_HANDLE;
+    budget = vblank_budget ? vblank_budget : UPLOAD_VBLANK_BUDGET;
+    stats = (UploadStats){ 0 };
+}
+
+void upload_set_budget(u32 vblank_budget) {
+    budget = vblank_budget;
+}
+
+static void insert_sorted(UploadItem* item) {
+    UploadItem** link = &pending;
+    while (*link && ((*link)->priority > item->priority ||
+                     ((*link)->priority == item->priority && (*link)->deadline <= item->deadline))) {
+        link = &(*link)->next;
+    }
+    item->next = *link;
+    *link = item;
+}
+
+bool upload_submit(const void* src, u32 dest, u32 size, DmaPriority priority, u32 deadline) {
+    u32 sr = interrupt_save_disable();
+    UploadItem** link;
+    UploadItem* item = 0;
+
+    for (link = &pending; *link; link = &(*link)->next) {
+        if ((*link)->src == (u32)src && (*link)->dest == dest) {
+            item = *link;
+            *link = item->next;
+            break;
+        }
+    }
+    if (item == 0) {
+        item = free_list;
+        if (item == 0) {
+            stats.dropped++;
+            interrupt_restore(sr);
+            return false;
+        }
+        free_list = item->next;
+        item->late = false;
+        item->size = 0;
+    }
+
+    // The source may have changed under the part already sent, so a
+    // resubmit starts over and covers the larger of the two ranges.
+    item->src = (u32)src;
+    item->dest = dest;
+    if (size > item->size) {
+        item->size = size;
+    }
+    item->sent = 0;
+    item->deadline = stats.frame + deadline;
+    item->priority = (u8)priority;
+    insert_sorted(item);
+
+    interrupt_restore(sr);
+    return true;
+}
+
+void upload_vblank(void) {
+    DmaTable table;
+    DmaTransfer t;
+    u32 remaining = budget;
+    u32 carried = 0;
+
+    stats.bytes = 0;
+    stats.transfers = 0;
+
+    if (dma_queue_status(batch) != DMA_REQ_DONE) {
+        stats.busy_frames++;
+        stats.frame++;
+        return;
+    }
+
+    dma_table_init(&table, table_entries, UPLOAD_TABLE_ENTRIES);
+
+    // Overdue uploads go first, then the rest in priority order.
+    for (int pass = 0; pass < 2; pass++) {
+        UploadItem** link = &pending;
+        while (*link && remaining > 0 && table.count < table.capacity) {
+            UploadItem* item = *link;
+            bool overdue = item->deadline <= stats.frame;
+            u32 chunk;
+
+            if (overdue != (pass == 0)) {
+                link = &item->next;
+                continue;
+            }
+
+            chunk = item->size - item->sent;
+            if (chunk > dma_max_size(DMA_CH0)) {
+                chunk = dma_max_size(DMA_CH0);
+            }
+            if (chunk > remaining) {
+                chunk = remaining & ~3u;
+                if (chunk == 0) {
+                    break;
+                }
+            }
+            dma_table_append(&table, (const void*)(item->src + item->sent),
+                             item->dest + item->sent, chunk);
+            remaining -= chunk;
+            stats.bytes += chunk;
+
+            item->sent += chunk;
+            if (item->sent == item->size) {
+                *link = item->next;
+                item->next = free_list;
+                free_list = item;
+            } else {
+                link = &item->next;
+            }
+        }
+    }
+
+    for (UploadItem* item = pending; item; item = item->next) {
+        carried++;
+        if (item->deadline <= stats.frame && !item->late) {
+            item->late = true;
+            stats.missed_deadlines++;
+        }
+    }
+    stats.carried = carried;
+    if (carried) {
+        stats.overflow_frames++;
+    }
+    stats.transfers = table.count;
+    stats.frame++;
+
+    if (table.count) {
+        t.src_addr = (u32)table.entries;
+        t.dest_addr = 0;
+        t.size = 0;
+        t.mode = DMA_MODE_INDIRECT;
+        batch = dma_queue_submit(DMA_CH0, &t, DMA_PRIORITY_HIGH, 0, 0);
+    }
+}
+
+const UploadStats* upload_stats(void) {
+    return &stats;
+}
@@ -1,37 +1,131 @@
 #include "saturn/dsp.h"
-#include "saturn/shared.h"
+#include "saturn/system.h"
+#include "saturn/hardware.h"
+
+#define PPAF_EXECUTE  0x00010000
+#define PPAF_STEP     0x00020000
+#define PPAF_LOAD_PC  0x00008000
+
+// Encodings used by the loader stub.
+#define OP_MVI_RA0     (0x80000000 | (0x6 << 26))
+#define OP_MOV_IMM_CT  (0x00001000 | (0xC << 8))
+#define OP_DMA_READ    (0xC0000000 | (0x1 << 15))
+#define OP_JMP_T0      (0xD0000000 | (0x68 << 19))
+#define OP_NOP         0x00000000
+#define OP_END         0xF0000000
+
+#define LOADER_SIZE 6
+
+static DspCallback end_callback;
+static void* end_arg;
+
+static void dsp_end_isr(void) {
+    (void)SCU_PPAF;
+    if (end_callback) {
+        end_callback(end_arg);
+    }
+}
 
 void dsp_init(void) {
+    dsp_stop();
+    (void)SCU_PPAF;
+    end_callback = 0;
+    interrupt_set_scu_handler(SCU_IRQ_DSP_END, dsp_end_isr);
+    interrupt_enable_scu(SCU_IRQ_DSP_END);
 }
 
 void dsp_reset(void) {
+    dsp_stop();
+    dsp_set_pc(0);
+    (void)SCU_PPAF;
 }
 
 void dsp_start(void) {
+    SCU_PPAF = PPAF_EXECUTE;
 }
 
 void dsp_stop(void) {
+    SCU_PPAF = 0;
+}
+
+void dsp_step(void) {
+    SCU_PPAF = PPAF_STEP;
+}
+
+bool dsp_busy(void) {
+    return (SCU_PPAF & PPAF_EXECUTE) != 0;
 }
 
 void dsp_wait(void) {
+    while (dsp_busy());
+}
+
+u32 dsp_flags(void) {
+    return SCU_PPAF;
 }
 
-void dsp_load_program(const u32* code, u32 size) {
-    (void)code;
-    (void)size;
+void dsp_set_end_callback(DspCallback callback, void* arg) {
+    u32 sr = interrupt_save_disable();
+    end_callback = callback;
+    end_arg = arg;
+    interrupt_restore(sr);
+}
+
+void dsp_load_program(const u32* code, u32 count) {
+    if (count > DSP_PROGRAM_SIZE) {
+        count = DSP_PROGRAM_SIZE;
+    }
+    dsp_stop();
+    dsp_set_pc(0);
+    for (u32 i = 0; i < count; i++) {
+        SCU_PPD = code[i];
+    }
+}
+
+void dsp_set_pc(u8 pc) {
+    SCU_PPAF = PPAF_LOAD_PC | pc;
 }
 
 void dsp_execute_program(void) {
+    dsp_set_pc(0);
+    dsp_start();
+}
+
+void dsp_write_data(u8 bank, u8 offset, const u32* data, u32 count) {
+    SCU_PDA = ((u32)(bank & 3) << 6) | (offset & 0x3F);
+    for (u32 i = 0; i < count; i++) {
+        SCU_PDD = data[i];
+    }
 }
 
-void dsp_set_register(u8 reg, u32 value) {
-    (void)reg;
-    (void)value;
+void dsp_read_data(u8 bank, u8 offset, u32* data, u32 count) {
+    SCU_PDA = ((u32)(bank & 3) << 6) | (offset & 0x3F);
+    for (u32 i = 0; i < count; i++) {
+        data[i] = SCU_PDD;
+    }
 }
 
-u32 dsp_get_register(u8 reg) {
-    (void)reg;
-    return 0;
+void dsp_dma_read(u8 bank, u8 offset, const void* src, u32 count) {
+    u32 stub[LOADER_SIZE];
+
+    if (count > DSP_BANK_SIZE) {
+        count = DSP_BANK_SIZE;
+    }
+
+    stub[0] = OP_MVI_RA0 | (((u32)src >> 2) & 0x01FFFFFF);
+    stub[1] = OP_MOV_IMM_CT | ((u32)(bank & 3) << 8) | (offset & 0x3F);
+    stub[2] = OP_DMA_READ | ((u32)(bank & 3) << 8) | count;
+    stub[3] = OP_JMP_T0 | (DSP_LOADER_ADDR + 3);
+    stub[4] = OP_NOP;
+    stub[5] = OP_END;
+
+    dsp_stop();
+    dsp_set_pc(DSP_LOADER_ADDR);
+    for (u32 i = 0; i < LOADER_SIZE; i++) {
+        SCU_PPD = stub[i];
+    }
+    dsp_set_pc(DSP_LOADER_ADDR);
+    dsp_start();
 }
 
 void dsp_matrix_mul(const Mat4* a, const Mat4* b, Mat4* result) {
@@ -43,3 +137,15 @@ void dsp_vector_transform(const Vec3* vec, const Mat4* mat, Vec3* result) {
     extern void vec3_transform(const Vec3*, const Mat4*, Vec3*);
     vec3_transform(vec, mat, result);
 }
+
+u8 dsp_outcode(const DspClipVolume* volume, const Vec3* vec) {
+    u8 code = 0;
+
+    if ((s32)vec->x < (s32)volume->min_x) code |= DSP_CLIP_LEFT;
+    if ((s32)vec->x > (s32)volume->max_x) code |= DSP_CLIP_RIGHT;
+    if ((s32)vec->y < (s32)volume->min_y) code |= DSP_CLIP_TOP;
+    if ((s32)vec->y > (s32)volume->max_y) code |= DSP_CLIP_BOTTOM;
+    if ((s32)vec->z < (s32)volume->near) code |= DSP_CLIP_NEAR;
+    if ((s32)vec->z > (s32)volume->far) code |= DSP_CLIP_FAR;
+    return code;
+}
@@ -0,0 +1,354 @@
+#include "saturn/dsp.h"
+#include "saturn/system.h"
+
+#define PARAM_BANK   3
+#define PARAM_OFFSET 3
+
+#define OUTCODE_GROUP        4
+#define OUTCODE_TESTS        6
+#define OUTCODE_TABLE_BANK   0
+#define OUTCODE_BIAS_OFFSET  24
+#define OUTCODE_BOUND_OFFSET 40
+
+// Bank 0 holds the matrix, bank 1 the input block, bank 2 the output
+// block. Bank 3: [0..2] vertex scratch, [3] 1.0, [4] matrix address,
+// [5] source address, [6] destination address, [7] word count,
+// [8] vertex count - 1. Addresses are in 32-bit words.
+// Source: tools/dsp/kernels/transform.dsp.
+static const u32 transform_program[] = {
+    0x00001F04, //     MOV 4,CT3
+    0x00003607, //     MOV MC3,RA0
+    0x00001C00, //     MOV 0,CT0
+    0xC000800C, //     DMA D0,MC0,12
+    0xD3400004, // 4:  JMP T0,4
+    0x00000000, //     NOP
+    0x00003607, //     MOV MC3,RA0
+    0x00003707, //     MOV MC3,WA0
+    0x00001D00, //     MOV 0,CT1
+    0xC000A103, //     DMA D0,MC1,M3
+    0xD340000A, // 10: JMP T0,10
+    0x00000000, //     NOP
+    0x00001F08, //     MOV 8,CT3
+    0x00003A03, //     MOV M3,LOP
+    0x00001C00, //     MOV 0,CT0
+    0x00001D00, //     MOV 0,CT1
+    0x00001E00, //     MOV 0,CT2
+    0x00001F00, //     MOV 0,CT3
+    0x00001B13, //     MOV 19,TOP
+    0x00003305, // 19: MOV MC1,MC3
+    0x00003305, //     MOV MC1,MC3
+    0x00003305, //     MOV MC1,MC3
+    0x00001F00, //     MOV 0,CT3
+    0x02790000, //     MOV MC3,X  MOV MC0,Y
+    0x037B0000, //     MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x19041F00, //     AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+    0x18040000, //     AD2  MOV ALU,A
+    0x0279320A, //     MOV MC3,X  MOV MC0,Y  MOV ALH,MC2
+    0x037B0000, //     MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x19041F00, //     AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+    0x18040000, //     AD2  MOV ALU,A
+    0x0279320A, //     MOV MC3,X  MOV MC0,Y  MOV ALH,MC2
+    0x037B0000, //     MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x19041F00, //     AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+    0x18041C00, //     AD2  MOV ALU,A  MOV 0,CT0
+    0x0000320A, //     MOV ALH,MC2
+    0xE0000000, //     BTM
+    0x00000000, //     NOP
+    0x00001E00, //     MOV 0,CT2
+    0x00001F07, //     MOV 7,CT3
+    0xC0013203, //     DMA MC2,D0,M3
+    0xD340002F, // 47: JMP T0,47
+    0x00000000, //     NOP
+    0xF8000000, //     ENDI
+};
+
+// Bank 0: [0..23] bit weights, [24] outcode bias, [40..63] negated
+// bounds for four vertices. Bank 3: [0] source address, [1] destination
+// address, [2] input word count, [3] group count - 1.
+// Source: tools/dsp/kernels/outcode.dsp.
+static const u32 outcode_program[] = {
+    0x00001F00, //     MOV 0,CT3
+    0x00003607, //     MOV MC3,RA0
+    0x00003707, //     MOV MC3,WA0
+    0x00001D00, //     MOV 0,CT1
+    0xC000A103, //     DMA D0,MC1,M3
+    0xD3400005, // 5:  JMP T0,5
+    0x00000000, //     NOP
+    0x00001F03, //     MOV 3,CT3
+    0x00003A03, //     MOV M3,LOP
+    0x00001C28, //     MOV 40,CT0
+    0x00001D00, //     MOV 0,CT1
+    0x00001E00, //     MOV 0,CT2
+    0x00001B0D, //     MOV 13,TOP
+    0x01C64000, // 13: MOV MC0,P  MOV M1,A
+    0x19C74000, //     AD2  MOV MC0,P  MOV MC1,A
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x19C6720A, //     AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+    0x19C7720A, //     AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+    0x1800320A, //     AD2  MOV ALH,MC2
+    0x0002320A, //     MOV ALH,MC2  CLR A
+    0x00001E00, //     MOV 0,CT2
+    0x01E00000, //     MOV MC2,P
+    0x19E01F08, //     AD2  MOV MC2,P  MOV 8,CT3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x19E0330A, //     AD2  MOV MC2,P  MOV ALH,MC3
+    0x1800330A, //     AD2  MOV ALH,MC3
+    0x0000330A, //     MOV ALH,MC3
+    0x00001F08, //     MOV 8,CT3
+    0x02791E00, //     MOV MC3,X  MOV MC0,Y  MOV 0,CT2
+    0x03790000, //     MOV MUL,P  MOV MC3,X  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x1B7D0000, //     AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+    0x19040000, //     AD2  MOV MUL,P  MOV ALU,A
+    0x19840000, //     AD2  MOV M0,P  MOV ALU,A
+    0x18040000, //     AD2  MOV ALU,A
+    0x00003309, //     MOV ALL,MC3
+    0x00001F20, //     MOV 32,CT3
+    0xC0011301, //     DMA MC3,D0,1
+    0xE0000000, //     BTM
+    0x00001C28, //     MOV 40,CT0
+    0xD3400063, // 99: JMP T0,99
+    0x00000000, //     NOP
+    0xF8000000, //     ENDI
+};
+
+typedef void (*JobSetup)(void);
+typedef void (*BlockParams)(u32 count);
+
+typedef struct {
+    JobSetup setup;
+    BlockParams params;
+    u32 block;
+    u32 src;
+    u32 dst;
+    u32 src_stride;
+    u32 dst_stride;
+    u32 remaining;
+    u32 table;
+    DspCallback callback;
+    void* arg;
+} DspJob;
+
+static DspJob job;
+static volatile bool job_busy;
+
+static void transform_params(u32 count) {
+    u32 params[6];
+
+    params[0] = FIX16_ONE;
+    params[1] = job.table >> 2;
+    params[2] = job.src >> 2;
+    params[3] = job.dst >> 2;
+    params[4] = count * 3;
+    params[5] = count - 1;
+    dsp_write_data(PARAM_BANK, PARAM_OFFSET, params, 6);
+}
+
+// Each test is "coord - bound < 0": max bounds become max + 1, and
+// their bits get a negative weight on top of a bias that presets them.
+static const s8 outcode_weights[OUTCODE_TESTS] = {
+    -DSP_CLIP_LEFT, DSP_CLIP_RIGHT, -DSP_CLIP_TOP, DSP_CLIP_BOTTOM, -DSP_CLIP_NEAR, DSP_CLIP_FAR
+};
+
+static void outcode_setup(void) {
+    const DspClipVolume* volume = (const DspClipVolume*)job.table;
+    u32 weights[OUTCODE_GROUP * OUTCODE_TESTS];
+    u32 bounds[OUTCODE_TESTS];
+    u32 bias = (DSP_CLIP_RIGHT | DSP_CLIP_BOTTOM | DSP_CLIP_FAR) * 0x01010101u;
+
+    for (u32 v = 0; v < OUTCODE_GROUP; v++) {
+        for (u32 k = 0; k < OUTCODE_TESTS; k++) {
+            weights[v * OUTCODE_TESTS + k] = (u32)(s32)outcode_weights[k] << (24 - v * 8);
+        }
+    }
+    bounds[0] = -volume->min_x;
+    bounds[1] = ~volume->max_x;
+    bounds[2] = -volume->min_y;
+    bounds[3] = ~volume->max_y;
+    bounds[4] = -volume->near;
+    bounds[5] = ~volume->far;
+
+    dsp_write_data(OUTCODE_TABLE_BANK, 0, weights, OUTCODE_GROUP * OUTCODE_TESTS);
+    dsp_write_data(OUTCODE_TABLE_BANK, OUTCODE_BIAS_OFFSET, &bias, 1);
+    for (u32 v = 0; v < OUTCODE_GROUP; v++) {
+        dsp_write_data(OUTCODE_TABLE_BANK, OUTCODE_BOUND_OFFSET + v * OUTCODE_TESTS, bounds, OUTCODE_TESTS);
+    }
+}
+
+static void outcode_params(u32 count) {
+    u32 params[4];
+
+    params[0] = job.src >> 2;
+    params[1] = job.dst >> 2;
+    params[2] = count * 3;
+    params[3] = (count + OUTCODE_GROUP - 1) / OUTCODE_GROUP - 1;
+    dsp_write_data(PARAM_BANK, 0, params, 4);
+}
+
+static void start_block(void) {
+    u32 count = job.remaining < job.block ? job.remaining : job.block;
+
+    job.params(count);
+    job.src += count * job.src_stride;
+    job.dst += count * job.dst_stride;
+    job.remaining -= count;
+    dsp_execute_program();
+}
+
+static void block_end(void* arg) {
+    (void)arg;
+    if (job.remaining) {
+        start_block();
+        return;
+    }
+    dsp_set_end_callback(0, 0);
+    job_busy = false;
+    if (job.callback) {
+        job.callback(job.arg);
+    }
+}
+
+static bool job_start(const u32* program, u32 size, const DspJob* config) {
+    u32 sr = interrupt_save_disable();
+
+    if (job_busy) {
+        interrupt_restore(sr);
+        return false;
+    }
+    job_busy = true;
+    interrupt_restore(sr);
+
+    job = *config;
+    dsp_load_program(program, size);
+    if (job.setup) {
+        job.setup();
+    }
+    dsp_set_end_callback(block_end, 0);
+    start_block();
+    return true;
+}
+
+bool dsp_transform_batch(const DspMatrix* matrix, const Vec3* src, Vec3* dst, u32 count,
+                         DspCallback callback, void* arg) {
+    DspJob config;
+
+    if (count == 0) {
+        return !job_busy;
+    }
+
+    config.setup = 0;
+    config.params = transform_params;
+    config.block = DSP_TRANSFORM_BLOCK;
+    config.src = (u32)src;
+    config.dst = (u32)dst;
+    config.src_stride = sizeof(Vec3);
+    config.dst_stride = sizeof(Vec3);
+    config.remaining = count;
+    config.table = (u32)matrix;
+    config.callback = callback;
+    config.arg = arg;
+    return job_start(transform_program, sizeof(transform_program) / sizeof(transform_program[0]), &config);
+}
+
+bool dsp_outcode_batch(const DspClipVolume* volume, const Vec3* src, u8* dst, u32 count,
+                       DspCallback callback, void* arg) {
+    DspJob config;
+
+    if (count == 0) {
+        return !job_busy;
+    }
+
+    config.setup = outcode_setup;
+    config.params = outcode_params;
+    config.block = DSP_OUTCODE_BLOCK;
+    config.src = (u32)src;
+    config.dst = (u32)dst;
+    config.src_stride = sizeof(Vec3);
+    config.dst_stride = 1;
+    config.remaining = count;
+    config.table = (u32)volume;
+    config.callback = callback;
+    config.arg = arg;
+    return job_start(outcode_program, sizeof(outcode_program) / sizeof(outcode_program[0]), &config);
+}
+
+bool dsp_job_busy(void) {
+    return job_busy;
+}
+
+void dsp_job_wait(void) {
+    while (job_busy);
+}
+
+void dsp_matrix_from_mat4(const Mat4* mat, DspMatrix* result) {
+    for (u32 r = 0; r < 3; r++) {
+        for (u32 k = 0; k < 4; k++) {
+            result->m[r][k] = mat->m[k][r];
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "saturn/jobs.h"
+#include "saturn/atomic.h"
+#include "saturn/cache.h"
+#include "saturn/cpuprof.h"
+#include "saturn/dualcpu.h"
+#include "config.h"
+
+#define JOB_MASK (JOB_QUEUE_DEPTH - 1)
+
+// head is only written by the master and tail only by the slave; both
+// count jobs since jobs_init(), so a job's id is head after its push and
+// it is done once tail has reached it.
+typedef struct {
+    u32 head;
+    u32 tail;
+    Job slots[JOB_QUEUE_DEPTH];
+} JobRing;
+
+// Uncached and volatile, so the slot stores reach memory before the head
+// store that publishes them.
+static volatile JobRing ring SAT_UNCACHED;
+
+void jobs_init(void) {
+    dualcpu_init();
+    ring.head = 0;
+    ring.tail = 0;
+}
+
+static u32 push(const Job* jobs, u32 count) {
+    u32 head = ring.head;
+    u32 free;
+    u32 n;
+
+    if (head - ring.tail == JOB_QUEUE_DEPTH) {
+        cpu_profile_begin(CPU_PROFILE_WAIT);
+        while (head - ring.tail == JOB_QUEUE_DEPTH) {
+            dualcpu_wait_for_slave();
+        }
+        cpu_profile_end(CPU_PROFILE_WAIT);
+    }
+    free = JOB_QUEUE_DEPTH - (head - ring.tail);
+    n = count < free ? count : free;
+    for (u32 i = 0; i < n; i++) {
+        volatile Job* slot = &ring.slots[(head + i) & JOB_MASK];
+        slot->func = jobs[i].func;
+        slot->arg = jobs[i].arg;
+        slot->done = jobs[i].done;
+    }
+    ring.head = head + n;
+    dualcpu_signal_slave();
+    return n;
+}
+
+JobId job_submit(JobFunc func, void* arg, volatile u32* done) {
+    Job job = { func, arg, done };
+
+    if (done) {
+        *(volatile u32*)UNCACHED(done) = 0;
+    }
+    push(&job, 1);
+    return ring.head;
+}
+
+JobId job_submit_batch(const Job* jobs, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        if (jobs[i].done) {
+            *(volatile u32*)UNCACHED(jobs[i].done) = 0;
+        }
+    }
+    while (count) {
+        u32 n = push(jobs, count);
+        jobs += n;
+        count -= n;
+    }
+    return ring.head;
+}
+
+bool job_done(JobId id) {
+    return (s32)(ring.tail - id) >= 0;
+}
+
+void job_wait(JobId id) {
+    if (job_done(id)) {
+        return;
+    }
+    cpu_profile_begin(CPU_PROFILE_WAIT);
+    while (!job_done(id)) {
+        dualcpu_wait_for_slave();
+    }
+    cpu_profile_end(CPU_PROFILE_WAIT);
+}
+
+void job_wait_all(void) {
+    job_wait(ring.head);
+}
+
+u32 job_pending(void) {
+    return ring.head - ring.tail;
+}
+
+void job_slave_loop(void) {
+    dualcpu_init();
+    while (1) {
+        u32 tail = ring.tail;
+        volatile Job* slot = &ring.slots[tail & JOB_MASK];
+        JobFunc func;
+        void* arg;
+        volatile u32* done;
+
+        if (ring.head == tail) {
+            cpu_profile_begin(CPU_PROFILE_IDLE);
+            while (ring.head == tail) {
+                dualcpu_wait_for_master();
+            }
+            cpu_profile_end(CPU_PROFILE_IDLE);
+        }
+        func = slot->func;
+        arg = slot->arg;
+        done = slot->done;
+
+        cpu_profile_begin(CPU_PROFILE_JOB);
+        cache_purge_all();
+        func(arg);
+        cpu_profile_end(CPU_PROFILE_JOB);
+        if (done) {
+            *(volatile u32*)UNCACHED(done) = 1;
+        }
+        ring.tail = tail + 1;
+        dualcpu_signal_master();
+    }
+}
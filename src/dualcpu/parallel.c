@@ -0,0 +1,81 @@
+#include "saturn/parallel.h"
+#include "saturn/atomic.h"
+#include "saturn/cache.h"
+#include "saturn/jobs.h"
+
+// lock and next are only accessed through the uncached mirror; the rest
+// is written by the master before the job is posted.
+typedef struct {
+    SpinLock lock;
+    u32 next;
+    u32 end;
+    u32 grain;
+    ParallelFunc fn;
+    void* ctx;
+} ALIGN16 ParallelState;
+
+static bool take(ParallelState* state, u32* begin, u32* end) {
+    SpinLock* lock = UNCACHED(&state->lock);
+    volatile u32* shared_next = UNCACHED(&state->next);
+    u32 next;
+
+    spin_lock(lock);
+    next = *shared_next;
+    if (next < state->end) {
+        *begin = next;
+        *end = state->end - next > state->grain ? next + state->grain : state->end;
+        *shared_next = *end;
+    }
+    spin_unlock(lock);
+    return next < state->end;
+}
+
+static void run_chunks(ParallelState* state) {
+    u32 begin, end;
+
+    while (take(state, &begin, &end)) {
+        state->fn(begin, end, state->ctx);
+    }
+}
+
+static void slave_chunks(void* arg) {
+    run_chunks(arg);
+}
+
+static void slave_half(void* arg) {
+    ParallelState* state = arg;
+    state->fn(state->next, state->end, state->ctx);
+}
+
+void sat_parallel_for(u32 begin, u32 end, u32 grain, ParallelFunc fn, void* ctx) {
+    ParallelState state;
+    JobId job;
+
+    if (begin >= end) {
+        return;
+    }
+    state.lock = (SpinLock){ 0 };
+    state.end = end;
+    state.grain = grain;
+    state.fn = fn;
+    state.ctx = ctx;
+
+    if (grain == 0) {
+        u32 mid = begin + (end - begin) / 2;
+        state.next = mid;
+        job = job_submit(slave_half, &state, 0);
+        if (mid > begin) {
+            fn(begin, mid, ctx);
+        }
+    } else {
+        // The first chunk is claimed before the slave can see the state.
+        u32 first = end - begin > grain ? begin + grain : end;
+        state.next = first;
+        job = job_submit(slave_chunks, &state, 0);
+        fn(begin, first, ctx);
+        run_chunks(&state);
+    }
+
+    job_wait(job);
+    cache_purge_all();
+}
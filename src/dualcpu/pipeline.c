@@ -0,0 +1,158 @@
+#include "saturn/pipeline.h"
+#include "saturn/atomic.h"
+#include "saturn/cpuprof.h"
+#include "saturn/jobs.h"
+#include "saturn/matrix.h"
+#include "saturn/memory.h"
+#include "saturn/system.h"
+#include "saturn/vdp1.h"
+#include "saturn/vector.h"
+#include "saturn/hardware.h"
+
+#define LIST_COUNT  3
+#define LIST_NONE   0xFF
+#define LIST_BASE   2
+#define JUMP_SLOT   1
+
+#define VDP1_CTRL_END         0x8000
+#define VDP1_CTRL_SKIP_ASSIGN 0x5000
+#define VDP1_PTMR_AUTO        0x0002
+
+// Shown, retired and ready list in one word, so each side reads a
+// consistent set. A retired list was shown until the last vblank and
+// may still be drawn this frame. The vblank handler only rewrites the
+// word while a list is ready and the slave only while none is.
+#define SHOWN(w)   ((w) & 0xFF)
+#define RETIRED(w) (((w) >> 8) & 0xFF)
+#define READY(w)   (((w) >> 16) & 0xFF)
+#define LISTS(shown, retired, ready) ((shown) | ((retired) << 8) | ((u32)(ready) << 16))
+
+static volatile u32 lists SAT_UNCACHED;
+static volatile u32 frames_shown SAT_UNCACHED;
+
+// Master side.
+static FramePacket packets[2] ALIGN16;
+static JobId packet_jobs[2];
+static u32 packet_index;
+
+// Slave side.
+static Vdp1Cmd cmd_buffer[PIPELINE_LIST_CMDS] ALIGN16;
+
+static volatile Vdp1Cmd* list_cmds(u32 list) {
+    return (volatile Vdp1Cmd*)VDP1_VRAM + LIST_BASE + list * PIPELINE_LIST_CMDS;
+}
+
+void pipeline_init(void) {
+    volatile Vdp1Cmd* jump = (volatile Vdp1Cmd*)VDP1_VRAM + JUMP_SLOT;
+
+    list_cmds(0)->ctrl = VDP1_CTRL_END;
+    jump->ctrl = VDP1_CTRL_SKIP_ASSIGN;
+    jump->link = (u16)(((u32)list_cmds(0) - VDP1_VRAM) >> 3);
+    lists = LISTS(0, LIST_NONE, LIST_NONE);
+    frames_shown = 0;
+
+    packet_jobs[0] = 0;
+    packet_jobs[1] = 0;
+    packet_index = 0;
+    VDP1_PTMR = VDP1_PTMR_AUTO;
+}
+
+FramePacket* pipeline_begin_frame(void) {
+    job_wait(packet_jobs[packet_index]);
+    return &packets[packet_index];
+}
+
+// pipeline_submit_frame() only hands out a packet once no list is
+// ready, so one of the three is free.
+static u32 free_list(void) {
+    u32 w = lists;
+    u32 list = 0;
+
+    while (list == SHOWN(w) || list == RETIRED(w)) {
+        list++;
+    }
+    return list;
+}
+
+static u32 build_mesh(const PipelineMesh* mesh, const Mat4* view_proj, Vdp1Cmd* cmd, u32 room) {
+    Mat4 mvp;
+    u32 count = mesh->quad_count < room ? mesh->quad_count : room;
+
+    mat4_mul(view_proj, &mesh->model, &mvp);
+    for (u32 i = 0; i < count; i++) {
+        const Vertex* verts = mesh->quads[i].vertices;
+        Vec3 p[4];
+
+        for (u32 v = 0; v < 4; v++) {
+            vec3_transform(&verts[v].position, &mvp, &p[v]);
+        }
+        cmd->ctrl = VDP1_CMD_POLYGON;
+        cmd->link = 0;
+        cmd->pmode = 0;
+        cmd->color = mesh->color;
+        cmd->x1 = (s16)((s32)p[0].x >> 16);
+        cmd->y1 = (s16)((s32)p[0].y >> 16);
+        cmd->x2 = (s16)((s32)p[1].x >> 16);
+        cmd->y2 = (s16)((s32)p[1].y >> 16);
+        cmd->x3 = (s16)((s32)p[2].x >> 16);
+        cmd->y3 = (s16)((s32)p[2].y >> 16);
+        cmd->x4 = (s16)((s32)p[3].x >> 16);
+        cmd->y4 = (s16)((s32)p[3].y >> 16);
+        cmd++;
+    }
+    return count;
+}
+
+// Runs on the slave as a job; the job loop has purged the slave's cache,
+// so the packet and the quads are read fresh.
+static void build_frame(void* arg) {
+    const FramePacket* packet = arg;
+    Mat4 view_proj;
+    u32 count = 0;
+    u32 list;
+
+    mat4_mul(&packet->projection, &packet->view, &view_proj);
+    for (u32 m = 0; m < packet->mesh_count; m++) {
+        count += build_mesh(&packet->meshes[m], &view_proj, &cmd_buffer[count],
+                            PIPELINE_LIST_CMDS - 1 - count);
+    }
+    cmd_buffer[count].ctrl = VDP1_CTRL_END;
+
+    list = free_list();
+    sat_memcpy((void*)list_cmds(list), cmd_buffer, (count + 1) * sizeof(Vdp1Cmd));
+    lists = (lists & ~LISTS(0, 0, 0xFF)) | LISTS(0, 0, list);
+}
+
+// Waiting here, on the master, keeps the build job from ever blocking
+// the job ring on list state.
+void pipeline_submit_frame(void) {
+    job_wait(packet_jobs[packet_index ^ 1]);
+    if (READY(lists) != LIST_NONE) {
+        cpu_profile_begin(CPU_PROFILE_WAIT);
+        while (READY(lists) != LIST_NONE) {
+            interrupt_sleep();
+        }
+        cpu_profile_end(CPU_PROFILE_WAIT);
+    }
+    packet_jobs[packet_index] = job_submit(build_frame, &packets[packet_index], 0);
+    packet_index ^= 1;
+}
+
+// If VDP1 fetched the jump before it was rewritten it draws the old
+// list once more, which is why that list stays retired for a frame.
+void pipeline_vblank(void) {
+    volatile Vdp1Cmd* jump = (volatile Vdp1Cmd*)VDP1_VRAM + JUMP_SLOT;
+    u32 w = lists;
+    u32 ready = READY(w);
+
+    if (ready == LIST_NONE) {
+        return;
+    }
+    jump->link = (u16)(((u32)list_cmds(ready) - VDP1_VRAM) >> 3);
+    lists = LISTS(ready, SHOWN(w), LIST_NONE);
+    frames_shown++;
+}
+
+u32 pipeline_frames_shown(void) {
+    return frames_shown;
+}
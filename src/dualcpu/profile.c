@@ -0,0 +1,140 @@
+#include "saturn/cpuprof.h"
+#include "saturn/atomic.h"
+#include "saturn/frt.h"
+
+#if CPU_PROFILE
+
+#define PROFILE_MASK (CPU_PROFILE_ENTRIES - 1)
+
+// Written by its own CPU, read by either; uncached so a WRAM dump or
+// the other CPU always sees the current state. The head is only moved
+// by the owner and the tail only by the reader.
+typedef struct {
+    u32 magic;
+    u32 head;
+    u32 tail;
+    u32 lost;
+    u32 high;
+    u32 last;
+    u32 starts[CPU_PROFILE_EVENT_COUNT];
+    u32 totals[CPU_PROFILE_EVENT_COUNT];
+    u32 jobs;
+    CpuProfileEntry ring[CPU_PROFILE_ENTRIES];
+} CpuProfile;
+
+static volatile CpuProfile profiles[2] SAT_UNCACHED;
+
+// Master only.
+static CpuProfileFrame frames[2];
+static u32 frame_totals[2][CPU_PROFILE_EVENT_COUNT];
+static u32 frame_jobs[2];
+static u32 frame_start;
+
+// The 16-bit count is extended on every call, so an interval is only
+// measured right if no call goes 78ms without one; waits wake at
+// least every millisecond.
+static u32 now(volatile CpuProfile* p) {
+    u32 t = frt_read();
+
+    if (t < p->last) {
+        p->high += 0x10000;
+    }
+    p->last = t;
+    return p->high | t;
+}
+
+void cpu_profile_init(void) {
+    volatile CpuProfile* p = &profiles[dualcpu_current_cpu()];
+
+    frt_init();
+    p->head = 0;
+    p->tail = 0;
+    p->lost = 0;
+    p->high = 0;
+    p->last = frt_read();
+    for (u32 i = 0; i < CPU_PROFILE_EVENT_COUNT; i++) {
+        p->starts[i] = 0;
+        p->totals[i] = 0;
+    }
+    p->jobs = 0;
+    p->magic = CPU_PROFILE_MAGIC;
+}
+
+void cpu_profile_begin(CpuProfileEvent event) {
+    volatile CpuProfile* p = &profiles[dualcpu_current_cpu()];
+    p->starts[event] = now(p);
+}
+
+void cpu_profile_end(CpuProfileEvent event) {
+    CpuId cpu = dualcpu_current_cpu();
+    volatile CpuProfile* p = &profiles[cpu];
+    u32 start = p->starts[event];
+    u32 end = now(p);
+    volatile CpuProfileEntry* e;
+
+    p->totals[event] += end - start;
+    if (event == CPU_PROFILE_JOB) {
+        p->jobs++;
+    }
+    if (p->head - p->tail == CPU_PROFILE_ENTRIES) {
+        p->lost++;
+        return;
+    }
+    e = &p->ring[p->head & PROFILE_MASK];
+    e->cpu = (u8)cpu;
+    e->event = (u8)event;
+    e->start = start;
+    e->end = end;
+    p->head++;
+}
+
+void cpu_profile_frame(void) {
+    volatile CpuProfile* master = &profiles[CPU_MASTER];
+    u32 t = now(master);
+
+    for (u32 cpu = 0; cpu < 2; cpu++) {
+        volatile CpuProfile* p = &profiles[cpu];
+        CpuProfileFrame* f = &frames[cpu];
+        u32 jobs = p->jobs;
+
+        f->frame_ticks = t - frame_start;
+        for (u32 i = 0; i < CPU_PROFILE_EVENT_COUNT; i++) {
+            u32 total = p->totals[i];
+            f->ticks[i] = total - frame_totals[cpu][i];
+            frame_totals[cpu][i] = total;
+        }
+        f->jobs = jobs - frame_jobs[cpu];
+        frame_jobs[cpu] = jobs;
+    }
+    frame_start = t;
+}
+
+const CpuProfileFrame* cpu_profile_last_frame(CpuId cpu) {
+    return &frames[cpu];
+}
+
+u32 cpu_profile_read(CpuId cpu, CpuProfileEntry* entries, u32 max) {
+    volatile CpuProfile* p = &profiles[cpu];
+    u32 tail = p->tail;
+    u32 head = p->head;
+    u32 count = 0;
+
+    while (count < max && tail != head) {
+        volatile CpuProfileEntry* e = &p->ring[tail & PROFILE_MASK];
+        entries[count].cpu = e->cpu;
+        entries[count].event = e->event;
+        entries[count].reserved = 0;
+        entries[count].start = e->start;
+        entries[count].end = e->end;
+        count++;
+        tail++;
+    }
+    p->tail = tail;
+    return count;
+}
+
+u32 cpu_profile_lost(CpuId cpu) {
+    return profiles[cpu].lost;
+}
+
+#endif
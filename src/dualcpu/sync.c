@@ -1,11 +1,82 @@
 #include "saturn/dualcpu.h"
 #include "saturn/hardware.h"
+#include "saturn/system.h"
+#include "saturn/frt.h"
+#include "saturn/cache.h"
+#include "saturn/atomic.h"
+#include "saturn/cpuprof.h"
 
 extern void _slave_entry(void);
 
 static volatile u32* slave_start = (volatile u32*)0x06000000;
 
+static volatile u8 events[2];
+
+// Purges asked of a CPU by the other one, handled from its signal
+// interrupt. seq is bumped by the asking CPU and done set to it by the
+// target, which then signals back; size 0 purges everything.
+typedef struct {
+    u32 seq;
+    u32 addr;
+    u32 size;
+    u32 done;
+} PurgeRequest;
+
+static volatile PurgeRequest purge_requests[2] SAT_UNCACHED;
+
+static void signal_other(CpuId cpu) {
+    if (cpu == CPU_MASTER) {
+        dualcpu_signal_slave();
+    } else {
+        dualcpu_signal_master();
+    }
+}
+
+static void serve_purge(CpuId cpu) {
+    volatile PurgeRequest* req = &purge_requests[cpu];
+    u32 seq = req->seq;
+
+    if (req->done != seq) {
+        if (req->size) {
+            cache_purge_range((const void*)req->addr, req->size);
+        } else {
+            cache_purge_all();
+        }
+        req->done = seq;
+        signal_other(cpu);
+    }
+}
+
+static void signal_isr(void) {
+    CpuId cpu = dualcpu_current_cpu();
+
+    (void)SH2_FTCSR;
+    SH2_FTCSR &= ~FRT_FTCSR_ICF;
+    serve_purge(cpu);
+    events[cpu] = 1;
+}
+
+// Callers loop on their own condition, so waking early is harmless.
+static void wait_event(void) {
+    volatile u8* event = &events[dualcpu_current_cpu()];
+
+    if (!*event) {
+        interrupt_sleep();
+    }
+    *event = 0;
+}
+
 void dualcpu_init(void) {
+    CpuId cpu = dualcpu_current_cpu();
+
+    events[cpu] = 0;
+    purge_requests[cpu].done = purge_requests[cpu].seq;
+    SH2_TIER &= ~FRT_TIER_ICIE;
+    (void)SH2_FTCSR;
+    SH2_FTCSR &= ~FRT_FTCSR_ICF;
+    interrupt_set_cpu_handler(FRT_VECTOR_ICI, signal_isr);
+    SH2_TIER |= FRT_TIER_ICIE;
+    cpu_profile_init();
 }
 
 void dualcpu_start_slave(void) {
@@ -17,21 +88,61 @@ void dualcpu_stop_slave(void) {
 }
 
 void dualcpu_signal_master(void) {
+    SH2_SIGNAL_MASTER = 0xFFFF;
 }
 
 void dualcpu_signal_slave(void) {
+    SH2_SIGNAL_SLAVE = 0xFFFF;
 }
 
 void dualcpu_wait_for_slave(void) {
+    wait_event();
 }
 
 void dualcpu_wait_for_master(void) {
+    wait_event();
+}
+
+void dualcpu_purge_range(CpuId cpu, const void* addr, u32 size) {
+    volatile PurgeRequest* req = &purge_requests[cpu];
+    u32 seq;
+
+    if (cpu == dualcpu_current_cpu()) {
+        if (size) {
+            cache_purge_range(addr, size);
+        } else {
+            cache_purge_all();
+        }
+        return;
+    }
+    seq = req->seq + 1;
+    req->addr = (u32)addr;
+    req->size = size;
+    req->seq = seq;
+    signal_other(dualcpu_current_cpu());
+
+    // Serving our own request too keeps two CPUs purging each other
+    // from deadlocking. The wait may eat a signal meant for another
+    // waiter, so the event is set again once done.
+    cpu_profile_begin(CPU_PROFILE_WAIT);
+    while (req->done != seq) {
+        serve_purge(dualcpu_current_cpu());
+        wait_event();
+    }
+    events[dualcpu_current_cpu()] = 1;
+    cpu_profile_end(CPU_PROFILE_WAIT);
 }
 
 void dualcpu_purge_cache(CpuId cpu) {
-    (void)cpu;
+    dualcpu_purge_range(cpu, 0, 0);
 }
 
 void dualcpu_flush_cache(CpuId cpu) {
-    (void)cpu;
+    dualcpu_purge_cache(cpu);
+}
+
+void dualcpu_publish(const void* addr, u32 size) {
+    if (size) {
+        dualcpu_purge_range(dualcpu_current_cpu() == CPU_MASTER ? CPU_SLAVE : CPU_MASTER, addr, size);
+    }
 }
@@ -0,0 +1,48 @@
+.section .text
+.global _interrupt_stubs
+
+! One stub per vector: save r0, load the vector number and join the
+! common path, which calls interrupt_dispatch(vector, vbr).
+.align 4
+_interrupt_stubs:
+.set vec, 0
+.rept 128
+    mov.l r0, @-r15
+    bra interrupt_common
+    mov #vec, r0
+.set vec, vec + 1
+.endr
+
+interrupt_common:
+    mov.l r1, @-r15
+    mov.l r2, @-r15
+    mov.l r3, @-r15
+    mov.l r4, @-r15
+    mov.l r5, @-r15
+    mov.l r6, @-r15
+    mov.l r7, @-r15
+    sts.l pr, @-r15
+    sts.l mach, @-r15
+    sts.l macl, @-r15
+    
+    mov.l _dispatch_ptr, r1
+    mov r0, r4
+    jsr @r1
+    stc vbr, r5
+    
+    lds.l @r15+, macl
+    lds.l @r15+, mach
+    lds.l @r15+, pr
+    mov.l @r15+, r7
+    mov.l @r15+, r6
+    mov.l @r15+, r5
+    mov.l @r15+, r4
+    mov.l @r15+, r3
+    mov.l @r15+, r2
+    mov.l @r15+, r1
+    mov.l @r15+, r0
+    rte
+    nop
+
+.align 4
+_dispatch_ptr: .long _interrupt_dispatch
@@ -0,0 +1,52 @@
+#include "saturn/cache.h"
+#include "saturn/hardware.h"
+#include "saturn/system.h"
+
+#define CCR_CE 0x01
+#define CCR_TW 0x08
+#define CCR_CP 0x10
+
+void cache_enable(void) {
+    SH2_CCR |= CCR_CE;
+}
+
+void cache_disable(void) {
+    SH2_CCR &= ~CCR_CE;
+}
+
+void cache_purge_all(void) {
+    SH2_CCR |= CCR_CP;
+}
+
+void cache_purge_range(const void* addr, u32 size) {
+    u32 a = (u32)addr;
+    u32 end = a + size;
+
+    if ((a >> 29) != 0) {
+        return;
+    }
+    if (size >= CACHE_SIZE) {
+        cache_purge_all();
+        return;
+    }
+    for (a &= ~(CACHE_LINE_SIZE - 1); a < end; a += CACHE_LINE_SIZE) {
+        *(volatile u32*)(SH2_CACHE_PURGE_AREA | a) = 0;
+    }
+}
+
+// The way count may only change with the cache off, and the lines of
+// the other mode are meaningless afterwards.
+void cache_set_mode(CacheMode mode) {
+    u32 sr = interrupt_save_disable();
+    u8 ccr = SH2_CCR;
+
+    SH2_CCR = ccr & ~CCR_CE;
+    ccr = mode == CACHE_MODE_2WAY_RAM ? (ccr | CCR_TW) : (ccr & ~CCR_TW);
+    SH2_CCR = (ccr & ~CCR_CE) | CCR_CP;
+    SH2_CCR = ccr;
+    interrupt_restore(sr);
+}
+
+CacheMode cache_mode(void) {
+    return (SH2_CCR & CCR_TW) ? CACHE_MODE_2WAY_RAM : CACHE_MODE_4WAY;
+}
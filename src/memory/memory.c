@@ -0,0 +1,207 @@
+#include "saturn/memory.h"
+#include "saturn/cache.h"
+#include "saturn/dma.h"
+#include "saturn/dmac.h"
+#include "saturn/dualcpu.h"
+#include "saturn/hardware.h"
+#include "saturn/system.h"
+#include "config.h"
+
+#define SCU_DMA_MAX_SIZE 0x100000
+
+typedef enum {
+    REGION_OTHER,
+    REGION_WRAM_L,
+    REGION_WRAM_H,
+    REGION_A_BUS,
+    REGION_B_BUS
+} MemRegion;
+
+static MemRegion region_of(u32 addr) {
+    u32 phys = addr & 0x07FFFFFF;
+
+    if ((addr >> 29) > 1) return REGION_OTHER;
+    if (phys >= 0x06000000) return REGION_WRAM_H;
+    if (phys >= 0x05A00000 && phys < 0x05FE0000) return REGION_B_BUS;
+    if (phys >= 0x02000000 && phys < 0x05900000) return REGION_A_BUS;
+    if (phys >= 0x00200000 && phys < 0x00300000) return REGION_WRAM_L;
+    return REGION_OTHER;
+}
+
+// The SCU cannot reach WRAM-L and cannot move data within one bus, and
+// its end interrupt only reaches the master.
+static bool scu_capable(u32 dst, u32 src, u32 size) {
+    MemRegion d = region_of(dst);
+    MemRegion s = region_of(src);
+
+    if (dualcpu_current_cpu() != CPU_MASTER || size >= SCU_DMA_MAX_SIZE) return false;
+    if (d == REGION_OTHER || d == REGION_WRAM_L) return false;
+    if (s == REGION_OTHER || s == REGION_WRAM_L) return false;
+    return d != s;
+}
+
+static void copy_cpu(u8* d, const u8* s, u32 size) {
+    if ((((u32)d ^ (u32)s) & 3) == 0) {
+        u32* dw;
+        const u32* sw;
+
+        for (; ((u32)d & 3) && size; size--) *d++ = *s++;
+        dw = (u32*)d;
+        sw = (const u32*)s;
+        for (; size >= 32; size -= 32, dw += 8, sw += 8) {
+            dw[0] = sw[0]; dw[1] = sw[1]; dw[2] = sw[2]; dw[3] = sw[3];
+            dw[4] = sw[4]; dw[5] = sw[5]; dw[6] = sw[6]; dw[7] = sw[7];
+        }
+        for (; size >= 4; size -= 4) *dw++ = *sw++;
+        d = (u8*)dw;
+        s = (const u8*)sw;
+    } else if ((((u32)d ^ (u32)s) & 1) == 0) {
+        u16* dh;
+        const u16* sh;
+
+        if (((u32)d & 1) && size) {
+            *d++ = *s++;
+            size--;
+        }
+        dh = (u16*)d;
+        sh = (const u16*)s;
+        for (; size >= 8; size -= 8, dh += 4, sh += 4) {
+            dh[0] = sh[0]; dh[1] = sh[1]; dh[2] = sh[2]; dh[3] = sh[3];
+        }
+        for (; size >= 2; size -= 2) *dh++ = *sh++;
+        d = (u8*)dh;
+        s = (const u8*)sh;
+    }
+    while (size--) *d++ = *s++;
+}
+
+static void set_cpu(u8* d, u32 pattern, u32 size) {
+    u32* dw;
+
+    for (; ((u32)d & 3) && size; size--) *d++ = (u8)pattern;
+    dw = (u32*)d;
+    for (; size >= 32; size -= 32, dw += 8) {
+        dw[0] = pattern; dw[1] = pattern; dw[2] = pattern; dw[3] = pattern;
+        dw[4] = pattern; dw[5] = pattern; dw[6] = pattern; dw[7] = pattern;
+    }
+    for (; size >= 4; size -= 4) *dw++ = pattern;
+    d = (u8*)dw;
+    for (u32 shift = 24; size; size--, shift -= 8) *d++ = (u8)(pattern >> shift);
+}
+
+// Channel 1 is left to synchronous copies so they only queue behind
+// each other, not behind long async transfers on channel 0. Both
+// queues complete from their end interrupts, so a caller that masks
+// them gets a CPU copy instead.
+static bool copy_dmac(u32 dst, u32 src, u32 size, u32 flags) {
+    DmacTransfer t;
+    DmaHandle handle;
+
+    if (interrupt_mask_level() >= DMAC_IRQ_LEVEL) {
+        return false;
+    }
+    t.src_addr = src;
+    t.dest_addr = dst;
+    t.size = size;
+    t.flags = flags;
+    handle = dmac_queue_submit(DMAC_CH1, &t, DMA_PRIORITY_HIGH, 0, 0);
+    if (handle == DMA_INVALID_HANDLE) {
+        return false;
+    }
+    dmac_queue_wait(handle);
+    return true;
+}
+
+static bool copy_scu(u32 dst, u32 src, u32 size) {
+    DmaTransfer t;
+    DmaHandle handle;
+
+    if (interrupt_mask_level() >= DMA0_END_IRQ_LEVEL) {
+        return false;
+    }
+    t.src_addr = src;
+    t.dest_addr = dst;
+    t.size = size;
+    t.mode = DMA_MODE_QUAD;
+    handle = dma_queue_submit(DMA_CH0, &t, DMA_PRIORITY_NORMAL, 0, 0);
+    if (handle == DMA_INVALID_HANDLE) {
+        return false;
+    }
+    dma_queue_wait(handle);
+    return true;
+}
+
+void* sat_memcpy_path(void* dst, const void* src, u32 size, MemPath path) {
+    u32 d = (u32)dst;
+    u32 s = (u32)src;
+    u32 head, words;
+
+    if (path == MEM_PATH_AUTO) {
+        if (size < MEMCPY_DMA_THRESHOLD) path = MEM_PATH_CPU;
+        else if (size >= MEMCPY_SCU_THRESHOLD && scu_capable(d, s, size)) path = MEM_PATH_SCU;
+        else path = MEM_PATH_DMAC;
+    }
+    if (path == MEM_PATH_SCU && !scu_capable(d, s, size)) {
+        path = MEM_PATH_DMAC;
+    }
+    if (path == MEM_PATH_CPU || ((d ^ s) & 3) ||
+        region_of(d) == REGION_OTHER || region_of(s) == REGION_OTHER) {
+        copy_cpu(dst, src, size);
+        return dst;
+    }
+
+    head = (4 - (d & 3)) & 3;
+    if (head > size) head = size;
+    words = (size - head) >> 2;
+    copy_cpu(dst, src, head);
+
+    if (words) {
+        if ((path == MEM_PATH_SCU && copy_scu(d + head, s + head, words * 4)) ||
+            copy_dmac(d + head, s + head, words * 4, 0)) {
+            cache_purge_range((void*)(d + head), words * 4);
+        } else {
+            copy_cpu((u8*)dst + head, (const u8*)src + head, words * 4);
+        }
+    }
+
+    copy_cpu((u8*)dst + head + words * 4, (const u8*)src + head + words * 4, (size - head) & 3);
+    return dst;
+}
+
+void* sat_memset32_path(void* dst, u32 pattern, u32 size, MemPath path) {
+    u32 d = (u32)dst;
+    u32 words = size >> 2;
+
+    if (path == MEM_PATH_AUTO) {
+        path = size < MEMSET_DMA_THRESHOLD ? MEM_PATH_CPU : MEM_PATH_DMAC;
+    }
+    if (path == MEM_PATH_CPU || words == 0 || (d & 3) || region_of(d) == REGION_OTHER) {
+        set_cpu(dst, pattern, size);
+        return dst;
+    }
+
+    // Fixed source: the DMAC re-reads the pattern word from the stack.
+    if (copy_dmac(d, (u32)&pattern, words * 4, DMAC_FIXED_SRC)) {
+        cache_purge_range((void*)d, words * 4);
+    } else {
+        set_cpu(dst, pattern, words * 4);
+    }
+    set_cpu((u8*)dst + words * 4, pattern, size & 3);
+    return dst;
+}
+
+void* sat_memcpy(void* dst, const void* src, u32 size) {
+    return sat_memcpy_path(dst, src, size, MEM_PATH_AUTO);
+}
+
+void* sat_memset32(void* dst, u32 pattern, u32 size) {
+    return sat_memset32_path(dst, pattern, size, MEM_PATH_AUTO);
+}
+
+void* sat_memset(void* dst, u8 value, u32 size) {
+    u8* d = dst;
+
+    for (; ((u32)d & 3) && size; size--) *d++ = value;
+    sat_memset32(d, value * 0x01010101u, size);
+    return dst;
+}
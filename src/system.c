@@ -1,10 +1,140 @@
 #include "saturn/types.h"
 #include "saturn/system.h"
+#include "saturn/dualcpu.h"
 #include "saturn/hardware.h"
+#include "saturn/frt.h"
+#include "saturn/cpuprof.h"
 
-static InterruptHandler vblank_handler = 0;
+// The BIOS keeps its copy of the SCU mask here.
+#define BIOS_SCU_MASK (*(volatile u32*)0x06000348)
+
+#define VECTOR_COUNT        128
+#define VECTOR_STUB_SIZE    6
+#define SCU_IRQ_VECTOR_BASE 0x40
+#define SCU_IMS_ALL         0x0000BFFF
+#define IPRB_FRT_MASK       0x0F00
+#define TVSTAT_VBLANK       0x0008
+
+// Longest interrupt_sleep() lasts: about 1ms at phi/32.
+#define WAKE_TICKS          800
+
+// VBR points at vectors; the stubs find handlers right after it.
+typedef struct {
+    u32 vectors[VECTOR_COUNT];
+    InterruptHandler handlers[VECTOR_COUNT];
+} VectorTable;
+
+extern const u8 interrupt_stubs[];
+
+#define STUB(vector) ((u32)&interrupt_stubs[(vector) * VECTOR_STUB_SIZE])
+
+void interrupt_dispatch(u32 vector, VectorTable* table);
+
+// SCU handlers always go in the master's table.
+static VectorTable vector_tables[2] ALIGN16;
+static bool initialized[2];
+static u32 scu_mask = SCU_IMS_ALL;
+
+// Master only: frames are counted in its VBlank-in interrupt.
+static volatile u32 frame_count;
+static u32 waited_frame;
+static u32 missed_frames;
+static bool pacing;
+
+// Called from the stubs in interrupt.s.
+void interrupt_dispatch(u32 vector, VectorTable* table) {
+    InterruptHandler handler = table->handlers[vector];
+    u32 irq = vector - SCU_IRQ_VECTOR_BASE;
+
+    if (irq < SCU_IRQ_COUNT) {
+        SCU_IST = ~(1u << irq);
+        if (irq == SCU_IRQ_VBLANK_IN) {
+            frame_count++;
+        }
+    }
+    if (handler) {
+        handler();
+    }
+}
+
+static void wake_isr(void) {
+    (void)SH2_FTCSR;
+    SH2_FTCSR &= ~FRT_FTCSR_OCFA;
+    SH2_TIER &= ~FRT_TIER_OCIAE;
+}
+
+// Vectors nothing was installed in keep what the previous table had, so
+// BIOS services keep working and handlers installed earlier stay.
+static void load_table(VectorTable* table) {
+    u32* old;
+
+    __asm__ volatile ("stc vbr, %0" : "=r"(old));
+    if (old != table->vectors) {
+        for (u32 i = 0; i < VECTOR_COUNT; i++) {
+            if (table->vectors[i] == 0) {
+                table->vectors[i] = old[i];
+            }
+        }
+        __asm__ volatile ("ldc %0, vbr" : : "r"(table->vectors));
+    }
+}
+
+// Handlers only ever run through a stub, so installing on the calling
+// CPU moves its VBR to the table even before system_init().
+static void install(VectorTable* table, u32 vector, InterruptHandler handler) {
+    u32 sr = interrupt_save_disable();
+
+    table->handlers[vector] = handler;
+    table->vectors[vector] = STUB(vector);
+    if (table == &vector_tables[dualcpu_current_cpu()]) {
+        load_table(table);
+    }
+    interrupt_restore(sr);
+}
 
 void system_init(void) {
+    CpuId cpu = dualcpu_current_cpu();
+    VectorTable* table = &vector_tables[cpu];
+    u32 sr = interrupt_save_disable();
+
+    load_table(table);
+
+    frt_init();
+    SH2_TIER &= ~FRT_TIER_OCIAE;
+    SH2_VCRC = (FRT_VECTOR_ICI << 8) | FRT_VECTOR_OCI;
+    SH2_IPRB = (SH2_IPRB & ~IPRB_FRT_MASK) | (FRT_IRQ_LEVEL << 8);
+    install(table, FRT_VECTOR_OCI, wake_isr);
+
+    // Keeps the VBlank handler and the SCU sources enabled so far.
+    if (cpu == CPU_MASTER && !initialized[cpu]) {
+        if (table->vectors[SCU_IRQ_VECTOR_BASE + SCU_IRQ_VBLANK_IN] !=
+            STUB(SCU_IRQ_VECTOR_BASE + SCU_IRQ_VBLANK_IN)) {
+            install(table, SCU_IRQ_VECTOR_BASE + SCU_IRQ_VBLANK_IN, 0);
+        }
+        scu_mask &= BIOS_SCU_MASK & ~(1u << SCU_IRQ_VBLANK_IN);
+        SCU_IMS = scu_mask;
+        pacing = false;
+        missed_frames = 0;
+    }
+    initialized[cpu] = true;
+    interrupt_restore(sr & ~0xF0);
+}
+
+// A compare match bounds the sleep, since an interrupt that arrives
+// between the caller's check and the sleep would otherwise leave it
+// asleep until the next one. With the FRT masked nothing would end the
+// sleep, so it returns at once and the caller polls.
+void interrupt_sleep(void) {
+    if (interrupt_mask_level() >= FRT_IRQ_LEVEL) {
+        return;
+    }
+    frt_set_compare(frt_read() + WAKE_TICKS);
+    (void)SH2_FTCSR;
+    SH2_FTCSR &= ~FRT_FTCSR_OCFA;
+    SH2_TIER |= FRT_TIER_OCIAE;
+    cpu_profile_begin(CPU_PROFILE_SLEEP);
+    __asm__ volatile ("sleep" ::: "memory");
+    cpu_profile_end(CPU_PROFILE_SLEEP);
 }
 
 void system_halt(void) {
@@ -12,15 +142,82 @@ void system_halt(void) {
 }
 
 void interrupt_enable_vblank(void) {
+    interrupt_enable_scu(SCU_IRQ_VBLANK_IN);
 }
 
 void interrupt_disable_vblank(void) {
+    interrupt_disable_scu(SCU_IRQ_VBLANK_IN);
+}
+
+// The slave gets no SCU interrupts and polls for the start of vblank,
+// as does the master while VBlank-in is masked.
+static void poll_vblank(u32 n) {
+    while (n--) {
+        while (VDP2_TVSTAT & TVSTAT_VBLANK);
+        while (!(VDP2_TVSTAT & TVSTAT_VBLANK));
+    }
+}
+
+void wait_frames(u32 n) {
+    u32 target;
+
+    if (dualcpu_current_cpu() != CPU_MASTER || interrupt_mask_level() == 0xF ||
+        (scu_mask & (1u << SCU_IRQ_VBLANK_IN))) {
+        poll_vblank(n);
+        return;
+    }
+    if (!pacing) {
+        waited_frame = frame_count;
+        pacing = true;
+    }
+    target = waited_frame + n;
+    if ((s32)(frame_count - target) >= 0) {
+        missed_frames += frame_count - target + 1;
+        target = frame_count + 1;
+    }
+    while ((s32)(frame_count - target) < 0) {
+        interrupt_sleep();
+    }
+    waited_frame = target;
 }
 
 void interrupt_wait_vblank(void) {
-    while (!(VDP2_TVSTAT & 0x0008));
+    wait_frames(1);
+}
+
+u32 system_frame_count(void) {
+    return frame_count;
+}
+
+u32 system_missed_frames(void) {
+    return missed_frames;
 }
 
 void interrupt_set_vblank_handler(InterruptHandler handler) {
-    vblank_handler = handler;
+    interrupt_set_scu_handler(SCU_IRQ_VBLANK_IN, handler);
+}
+
+void interrupt_set_cpu_handler(u32 vector, InterruptHandler handler) {
+    install(&vector_tables[dualcpu_current_cpu()], vector, handler);
+}
+
+void interrupt_set_scu_handler(ScuIrq irq, InterruptHandler handler) {
+    install(&vector_tables[CPU_MASTER], SCU_IRQ_VECTOR_BASE + irq, handler);
+}
+
+// IMS is write-only, so the mask is kept here.
+void interrupt_enable_scu(ScuIrq irq) {
+    u32 sr = interrupt_save_disable();
+
+    scu_mask &= ~(1u << irq);
+    SCU_IMS = scu_mask;
+    interrupt_restore(sr);
+}
+
+void interrupt_disable_scu(ScuIrq irq) {
+    u32 sr = interrupt_save_disable();
+
+    scu_mask |= 1u << irq;
+    SCU_IMS = scu_mask;
+    interrupt_restore(sr);
 }
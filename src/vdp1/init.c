@@ -1,10 +1,38 @@
 #include "saturn/vdp1.h"
+#include "saturn/display.h"
+#include "saturn/memory.h"
 #include "saturn/hardware.h"
+#include "saturn/system.h"
 
-static volatile Vdp1Cmd* cmd_list = (volatile Vdp1Cmd*)VDP1_VRAM;
+#define VDP1_CTRL_SYSTEM_CLIP 0x0009
+#define VDP1_CTRL_SKIP_ASSIGN 0x5000
+
+// Slot 0 holds the system clipping rectangle and slot 1 jumps to the
+// draw list, which starts at slot 2.
+#define CLIP_SLOT   0
+#define JUMP_SLOT   1
+#define LIST_BASE   2
+
+static volatile Vdp1Cmd* cmd_list = (volatile Vdp1Cmd*)VDP1_VRAM + LIST_BASE;
+static u16 fbcr_mode = 0;
+
+static void set_clip(u16 width, u16 height) {
+    volatile Vdp1Cmd* clip = (volatile Vdp1Cmd*)VDP1_VRAM + CLIP_SLOT;
+
+    clip->ctrl = VDP1_CTRL_SYSTEM_CLIP;
+    clip->link = 0;
+    clip->x3 = (s16)(width - 1);
+    clip->y3 = (s16)(height - 1);
+}
 
 void vdp1_init(void) {
-    VDP1_FBCR = 0;
+    volatile Vdp1Cmd* jump = (volatile Vdp1Cmd*)VDP1_VRAM + JUMP_SLOT;
+
+    set_clip(display_width(), display_height());
+    jump->ctrl = VDP1_CTRL_SKIP_ASSIGN;
+    jump->link = (u16)((LIST_BASE * sizeof(Vdp1Cmd)) >> 3);
+
+    VDP1_FBCR = fbcr_mode;
     VDP1_PTMR = 0;
     VDP1_EWDR = 0;
     VDP1_EWLR = 0;
@@ -12,8 +40,27 @@ void vdp1_init(void) {
     VDP1_ENDR = 0;
 }
 
+void vdp1_set_resolution(u16 width, u16 height, bool hires, bool double_density) {
+    u16 field_height = double_density ? height >> 1 : height;
+
+    VDP1_TVMR = hires ? 0x0001 : 0x0000;
+    fbcr_mode = double_density ? 0x0008 : 0x0000;
+    VDP1_FBCR = fbcr_mode;
+
+    // Erase X is in 8-dot units, 16-dot units for the 8bpp hi-res buffer.
+    VDP1_EWLR = 0;
+    VDP1_EWRR = (u16)(((width >> (hires ? 4 : 3)) << 9) | ((field_height - 1) & 0x1FF));
+
+    set_clip(width, height);
+}
+
+void vdp1_set_field(bool odd) {
+    fbcr_mode = (fbcr_mode & ~0x0004) | (odd ? 0x0004 : 0x0000);
+    VDP1_FBCR = fbcr_mode;
+}
+
 void vdp1_wait_for_vblank(void) {
-    while (!(VDP1_PTMR & 0x02));
+    interrupt_wait_vblank();
 }
 
 void vdp1_start_frame(void) {
@@ -25,10 +72,12 @@ void vdp1_end_frame(void) {
 }
 
 void vdp1_clear_screen(u16 color) {
-    volatile u16* fb = (volatile u16*)0x25E00000;
-    for (int i = 0; i < 320 * 224; i++) {
-        fb[i] = color;
+    u32 size = (u32)display_width() * display_height() * 2;
+
+    if (size > VDP2_VRAM_SIZE) {
+        size = VDP2_VRAM_SIZE;
     }
+    sat_memset32((void*)VDP2_VRAM, color * 0x00010001u, size);
 }
 
 Vdp1Cmd* vdp1_allocate_cmd(void) {
@@ -41,7 +90,7 @@ void vdp1_submit_cmd(Vdp1Cmd* cmd) {
 }
 
 void vdp1_flush_cmd_list(void) {
-    VDP1_FBCR = 0x02;
+    VDP1_FBCR = 0x02 | fbcr_mode;
 }
 
 void vdp1_draw_quad(const Vdp1Cmd* cmd) {
@@ -0,0 +1,51 @@
+#include "saturn/display.h"
+#include "saturn/vdp1.h"
+#include "saturn/vdp2.h"
+#include "saturn/hardware.h"
+#include "config.h"
+
+static const u16 mode_widths[4] = { 320, 352, 640, 704 };
+static const u16 mode_lines[3] = { 224, 240, 256 };
+
+static DisplayInfo info = {
+    SCREEN_WIDTH, SCREEN_HEIGHT, FRAMERATE, DISPLAY_NTSC, false, false
+};
+
+bool display_set_mode(const DisplayMode* mode) {
+    bool pal = (VDP2_TVSTAT & 0x0001) != 0;
+    bool double_density = mode->interlace == DISPLAY_INTERLACE_DOUBLE;
+
+    if ((u32)mode->width > DISPLAY_WIDTH_704 || (u32)mode->lines > DISPLAY_LINES_256) {
+        return false;
+    }
+    if (mode->interlace != DISPLAY_PROGRESSIVE &&
+        mode->interlace != DISPLAY_INTERLACE_SINGLE &&
+        mode->interlace != DISPLAY_INTERLACE_DOUBLE) {
+        return false;
+    }
+    if (mode->lines == DISPLAY_LINES_256 && !pal) {
+        return false;
+    }
+
+    info.width = mode_widths[mode->width];
+    info.height = (u16)(mode_lines[mode->lines] << (double_density ? 1 : 0));
+    info.framerate = pal ? 50 : 60;
+    info.standard = pal ? DISPLAY_PAL : DISPLAY_NTSC;
+    info.hires = mode->width >= DISPLAY_WIDTH_640;
+    info.double_density = double_density;
+
+    vdp2_reg_modify(&VDP2_TVMD, 0x00F7,
+                    (u16)((mode->interlace << 6) | (mode->lines << 4) | mode->width));
+    vdp1_set_resolution(info.width, info.height, info.hires, double_density);
+    return true;
+}
+
+const DisplayInfo* display_info(void) {
+    return &info;
+}
+
+void display_field_update(void) {
+    if (info.double_density) {
+        vdp1_set_field((VDP2_TVSTAT & 0x0002) != 0);
+    }
+}
@@ -0,0 +1,115 @@
+#include "saturn/vdp2.h"
+#include "saturn/display.h"
+#include "saturn/hardware.h"
+
+static volatile u16* const priority_reg[6] = { &VDP2_PRINA, &VDP2_PRINA, &VDP2_PRINB, &VDP2_PRINB, &VDP2_PRIR, &VDP2_PRINA };
+static volatile u16* const ratio_reg[6] = { &VDP2_CCRNA, &VDP2_CCRNA, &VDP2_CCRNB, &VDP2_CCRNB, &VDP2_CCRR, &VDP2_CCRNA };
+static volatile u16* const sprite_priority_reg[4] = { &VDP2_PRISA, &VDP2_PRISB, &VDP2_PRISC, &VDP2_PRISD };
+static volatile u16* const sprite_ratio_reg[4] = { &VDP2_CCRSA, &VDP2_CCRSB, &VDP2_CCRSC, &VDP2_CCRSD };
+static volatile u16* const window_reg[8] = {
+    &VDP2_WCTLA, &VDP2_WCTLA, &VDP2_WCTLB, &VDP2_WCTLB,
+    &VDP2_WCTLC, &VDP2_WCTLC, &VDP2_WCTLD, &VDP2_WCTLD
+};
+static const u8 layer_shift[6] = { 0, 8, 0, 8, 0, 0 };
+
+// RBG1 shares the NBG0 priority, ratio and enable bits.
+static inline u32 layer_bit(Vdp2BgLayer layer) {
+    return layer == BG_RBG1 ? 0 : (u32)layer;
+}
+
+void vdp2_set_priority(Vdp2BgLayer layer, u8 priority) {
+    u32 shift = layer_shift[layer];
+    vdp2_reg_modify(priority_reg[layer], 0x7 << shift, (priority & 0x7) << shift);
+}
+
+void vdp2_set_sprite_type(u8 type) {
+    vdp2_reg_modify(&VDP2_SPCTL, 0x000F, type);
+}
+
+void vdp2_set_sprite_priority(u8 reg, u8 priority) {
+    u32 shift = (reg & 1) * 8;
+    vdp2_reg_modify(sprite_priority_reg[(reg >> 1) & 3], 0x7 << shift, (priority & 0x7) << shift);
+}
+
+void vdp2_set_color_calc_mode(Vdp2ColorCalcMode mode) {
+    u16 bits = 0;
+    if (mode == VDP2_CC_RATIO_SECOND) bits = 0x0200;
+    if (mode == VDP2_CC_ADD) bits = 0x0100;
+    vdp2_reg_modify(&VDP2_CCCTL, 0x0300, bits);
+}
+
+void vdp2_set_color_calc(Vdp2BgLayer layer, bool enable, u8 ratio) {
+    u32 shift = layer_shift[layer];
+    vdp2_reg_modify(ratio_reg[layer], 0x1F << shift, (ratio & 0x1F) << shift);
+    vdp2_reg_modify(&VDP2_CCCTL, 1 << layer_bit(layer), enable ? 0xFFFF : 0x0000);
+}
+
+void vdp2_set_sprite_color_calc(bool enable, u8 reg, u8 ratio) {
+    u32 shift = (reg & 1) * 8;
+    vdp2_reg_modify(sprite_ratio_reg[(reg >> 1) & 3], 0x1F << shift, (ratio & 0x1F) << shift);
+    // Condition "priority >= 0" makes every sprite pixel take part.
+    vdp2_reg_modify(&VDP2_SPCTL, 0x3700, 0x2000);
+    vdp2_reg_modify(&VDP2_CCCTL, 0x0040, enable ? 0x0040 : 0x0000);
+}
+
+void vdp2_set_shadow(Vdp2BgLayer layer, bool enable) {
+    vdp2_reg_modify(&VDP2_SDCTL, 1 << layer_bit(layer), enable ? 0xFFFF : 0x0000);
+}
+
+void vdp2_set_line_color(u32 table_addr, bool per_line, u16 layer_mask) {
+    u32 addr = table_addr >> 1;
+    u16 enable = 0;
+
+    for (u32 layer = BG_NBG0; layer <= BG_RBG1; layer++) {
+        if (layer_mask & (1 << layer)) {
+            enable |= 1 << layer_bit((Vdp2BgLayer)layer);
+        }
+    }
+    vdp2_reg_write(&VDP2_LCTAU, (per_line ? 0x8000 : 0x0000) | ((addr >> 16) & 0x7));
+    vdp2_reg_write(&VDP2_LCTAL, (u16)addr);
+    vdp2_reg_write(&VDP2_LNCLEN, enable);
+}
+
+void vdp2_set_window_rect(Vdp2Window window, s16 x1, s16 y1, s16 x2, s16 y2) {
+    volatile u16* base = window == VDP2_WINDOW_0 ? &VDP2_WPSX0 : &VDP2_WPSX1;
+    u32 shift = display_info()->hires ? 0 : 1;
+
+    // Horizontal positions are in half-dot units at normal resolution.
+    vdp2_reg_write(&base[0], (u16)(x1 << shift) & 0x03FF);
+    vdp2_reg_write(&base[1], (u16)y1 & 0x01FF);
+    vdp2_reg_write(&base[2], (u16)(x2 << shift) & 0x03FF);
+    vdp2_reg_write(&base[3], (u16)y2 & 0x01FF);
+}
+
+void vdp2_set_line_window(Vdp2Window window, bool enable, u32 table_addr) {
+    volatile u16* upper = window == VDP2_WINDOW_0 ? &VDP2_LWTA0U : &VDP2_LWTA1U;
+    u32 addr = table_addr >> 1;
+
+    vdp2_reg_write(&upper[0], (enable ? 0x8000 : 0x0000) | ((addr >> 16) & 0x7));
+    vdp2_reg_write(&upper[1], (u16)addr & 0xFFFE);
+}
+
+void vdp2_set_window(Vdp2WindowTarget target, u8 flags) {
+    u32 shift = (target & 1) * 8;
+    vdp2_reg_modify(window_reg[target], 0xBF << shift, (u16)flags << shift);
+}
+
+void vdp2_preset_translucent(Vdp2BgLayer layer, u8 ratio) {
+    vdp2_set_color_calc_mode(VDP2_CC_RATIO_TOP);
+    vdp2_set_color_calc(layer, true, ratio);
+}
+
+void vdp2_preset_shadows(u16 layer_mask) {
+    for (u32 layer = BG_NBG0; layer <= BG_RBG0; layer++) {
+        vdp2_set_shadow((Vdp2BgLayer)layer, (layer_mask & VDP2_LAYER_MASK(layer)) != 0);
+    }
+}
+
+void vdp2_preset_spotlight(u16 layer_mask, s16 x1, s16 y1, s16 x2, s16 y2) {
+    vdp2_set_window_rect(VDP2_WINDOW_0, x1, y1, x2, y2);
+    for (u32 layer = BG_NBG0; layer <= BG_RBG0; layer++) {
+        if (layer_mask & VDP2_LAYER_MASK(layer)) {
+            vdp2_set_window((Vdp2WindowTarget)layer, VDP2_WIN_W0 | VDP2_WIN_W0_OUTSIDE);
+        }
+    }
+}
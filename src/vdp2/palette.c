@@ -0,0 +1,149 @@
+#include "saturn/palette.h"
+#include "saturn/upload.h"
+#include "saturn/shared.h"
+
+#define PAIR_COUNT (PALETTE_SIZE / 2)
+
+// Two RGB555 entries per word, split into two lane sets with at least
+// ten bits between channels so a 5-bit channel times a 0..32 weight
+// never carries into its neighbour.
+#define LANE_MASK_A  0x03E07C1F
+#define LANE_MASK_B  0x03E0F81F
+#define CHANNEL_MASK 0x001F001F
+#define MSB_MASK     0x80008000
+
+#define LERP(a, wa, tb_a, tb_b) \
+    (((((a) & LANE_MASK_A) * (wa) + (tb_a)) >> 5 & LANE_MASK_A) | \
+     (((((a) >> 5) & LANE_MASK_B) * (wa) + (tb_b)) >> 5 & LANE_MASK_B) << 5 | \
+     ((a) & MSB_MASK))
+
+static u32 source[PAIR_COUNT] ALIGN16;
+static u32 work[PAIR_COUNT] ALIGN16;
+static u32 dirty_lo = PAIR_COUNT;
+static u32 dirty_hi = 0;
+
+static inline void pair_range(u32 first, u32 count, u32* lo, u32* hi) {
+    u32 end = first + count;
+    if (end > PALETTE_SIZE) {
+        end = PALETTE_SIZE;
+    }
+    *lo = first >> 1;
+    *hi = (end + 1) >> 1;
+}
+
+static inline void mark_dirty(u32 lo, u32 hi) {
+    if (lo < dirty_lo) dirty_lo = lo;
+    if (hi > dirty_hi) dirty_hi = hi;
+}
+
+void palette_init(void) {
+    for (u32 i = 0; i < PAIR_COUNT; i++) {
+        source[i] = 0;
+        work[i] = 0;
+    }
+    mark_dirty(0, PAIR_COUNT);
+}
+
+void palette_load(u32 first, const color_t* colors, u32 count) {
+    color_t* src = (color_t*)source;
+    color_t* dst = (color_t*)work;
+    u32 lo, hi;
+
+    if (first >= PALETTE_SIZE) {
+        return;
+    }
+    if (count > PALETTE_SIZE - first) {
+        count = PALETTE_SIZE - first;
+    }
+    for (u32 i = 0; i < count; i++) {
+        src[first + i] = colors[i];
+        dst[first + i] = colors[i];
+    }
+    pair_range(first, count, &lo, &hi);
+    mark_dirty(lo, hi);
+}
+
+void palette_set(u32 index, color_t color) {
+    if (index >= PALETTE_SIZE) {
+        return;
+    }
+    ((color_t*)work)[index] = color;
+    mark_dirty(index >> 1, (index >> 1) + 1);
+}
+
+void palette_restore(u32 first, u32 count) {
+    u32 lo, hi;
+    pair_range(first, count, &lo, &hi);
+    for (u32 i = lo; i < hi; i++) {
+        work[i] = source[i];
+    }
+    mark_dirty(lo, hi);
+}
+
+void palette_fade_to(u32 first, u32 count, color_t color, u32 level) {
+    u32 target = ((u32)color << 16) | color;
+    u32 wa = PALETTE_LEVEL_MAX - level;
+    u32 tb_a = (target & LANE_MASK_A) * level;
+    u32 tb_b = ((target >> 5) & LANE_MASK_B) * level;
+    u32 lo, hi, i;
+
+    pair_range(first, count, &lo, &hi);
+    for (i = lo; i + 4 <= hi; i += 4) {
+        u32 a0 = source[i], a1 = source[i + 1], a2 = source[i + 2], a3 = source[i + 3];
+        work[i]     = LERP(a0, wa, tb_a, tb_b);
+        work[i + 1] = LERP(a1, wa, tb_a, tb_b);
+        work[i + 2] = LERP(a2, wa, tb_a, tb_b);
+        work[i + 3] = LERP(a3, wa, tb_a, tb_b);
+    }
+    for (; i < hi; i++) {
+        work[i] = LERP(source[i], wa, tb_a, tb_b);
+    }
+    mark_dirty(lo, hi);
+}
+
+void palette_crossfade(u32 first, u32 count, const color_t* target, u32 level) {
+    const u32* t = (const u32*)target;
+    u32 wa = PALETTE_LEVEL_MAX - level;
+    u32 lo, hi, i;
+
+    pair_range(first, count, &lo, &hi);
+    t -= lo;
+    for (i = lo; i + 2 <= hi; i += 2) {
+        u32 a0 = source[i], a1 = source[i + 1];
+        u32 b0 = t[i], b1 = t[i + 1];
+        work[i]     = LERP(a0, wa, (b0 & LANE_MASK_A) * level, ((b0 >> 5) & LANE_MASK_B) * level);
+        work[i + 1] = LERP(a1, wa, (b1 & LANE_MASK_A) * level, ((b1 >> 5) & LANE_MASK_B) * level);
+    }
+    if (i < hi) {
+        u32 b = t[i];
+        work[i] = LERP(source[i], wa, (b & LANE_MASK_A) * level, ((b >> 5) & LANE_MASK_B) * level);
+    }
+    mark_dirty(lo, hi);
+}
+
+void palette_tint(u32 first, u32 count, u32 r, u32 g, u32 b) {
+    u32 lo, hi;
+
+    pair_range(first, count, &lo, &hi);
+    for (u32 i = lo; i < hi; i++) {
+        u32 a = source[i];
+        work[i] = ((((a      ) & CHANNEL_MASK) * r >> 5) & CHANNEL_MASK)
+                | ((((a >>  5) & CHANNEL_MASK) * g >> 5) & CHANNEL_MASK) << 5
+                | ((((a >> 10) & CHANNEL_MASK) * b >> 5) & CHANNEL_MASK) << 10
+                | (a & MSB_MASK);
+    }
+    mark_dirty(lo, hi);
+}
+
+void palette_upload(void) {
+    if (dirty_lo >= dirty_hi) {
+        return;
+    }
+
+    // With the scheduler full the range stays dirty for the next call.
+    if (upload_submit(&work[dirty_lo], VDP2_CRAM + dirty_lo * 4, (dirty_hi - dirty_lo) * 4,
+                      DMA_PRIORITY_HIGH, 0)) {
+        dirty_lo = PAIR_COUNT;
+        dirty_hi = 0;
+    }
+}
@@ -0,0 +1,142 @@
+#include "saturn/rotation.h"
+#include "saturn/vdp2.h"
+#include "saturn/upload.h"
+#include "saturn/fixed.h"
+#include "saturn/shared.h"
+#include "saturn/display.h"
+#include "saturn/hardware.h"
+
+#define ROT_COORD_MASK  0x1FFFFFC0
+#define ROT_DELTA_MASK  0x0007FFC0
+#define ROT_MATRIX_MASK 0x000FFFC0
+#define ROT_SHIFT_MASK  0x3FFFFFC0
+#define ROT_SCALE_MASK  0x00FFFFFF
+#define ROT_KAST_MASK   0xFFFFFFC0
+#define ROT_DKA_MASK    0x03FFFFC0
+
+#define COEF_TRANSPARENT 0x80000000
+#define COEF_MAX         0x007FFFFF
+#define COEF_MIN_DENOM   0x00000400
+
+static Vdp2RotParams params[2] ALIGN16;
+static u32 coefs[2][RBG0_MAX_LINES] ALIGN16;
+
+static u32 param_addr;
+static u32 coef_addr;
+static u32 coef_lines;
+static bool sky_enabled;
+static s32 sky_height;
+
+static inline s32 fx_mul(s32 a, s32 b) {
+    return (s32)(((s64)a * b) >> 16);
+}
+
+static inline s32 fx_div(s32 a, s32 b) {
+    return (s32)(((s64)a << 16) / b);
+}
+
+static u32 line_coef(s32 height, s32 denom) {
+    if (denom < COEF_MIN_DENOM) {
+        return COEF_TRANSPARENT;
+    }
+    s32 k = fx_div(height, denom);
+    if (k > COEF_MAX) {
+        return COEF_TRANSPARENT;
+    }
+    return (u32)k & ROT_SCALE_MASK;
+}
+
+static void build_table(Vdp2RotParams* t, const Rbg0Camera* cam, u32 coef_index, s32 sin_p, s32 cos_p) {
+    s32 sin_y = (s32)fix16_sin(cam->yaw);
+    s32 cos_y = (s32)fix16_cos(cam->yaw);
+    s32 half_w = (display_width() / 2) << FIX16_SHIFT;
+    s32 half_h = (display_height() / 2) << FIX16_SHIFT;
+    s32 dist = (s32)cam->distance;
+
+    t->xst = -half_w & ROT_COORD_MASK;
+    t->yst = (fx_mul(dist, cos_p) + fx_mul(half_h, sin_p)) & ROT_COORD_MASK;
+    t->zst = 0;
+    t->dxst = 0;
+    t->dyst = -sin_p & ROT_DELTA_MASK;
+    t->dx = FIX16_ONE & ROT_DELTA_MASK;
+    t->dy = 0;
+
+    t->a = cos_y & ROT_MATRIX_MASK;
+    t->b = sin_y & ROT_MATRIX_MASK;
+    t->c = 0;
+    t->d = sin_y & ROT_MATRIX_MASK;
+    t->e = -cos_y & ROT_MATRIX_MASK;
+    t->f = 0;
+
+    t->px = t->py = t->pz = 0;
+    t->cx = t->cy = t->cz = 0;
+    t->mx = (s32)cam->x & ROT_SHIFT_MASK;
+    t->my = (s32)cam->y & ROT_SHIFT_MASK;
+    t->kx = FIX16_ONE;
+    t->ky = FIX16_ONE;
+
+    t->kast = (coef_index << FIX16_SHIFT) & ROT_KAST_MASK;
+    t->dkast = FIX16_ONE & ROT_DKA_MASK;
+    t->dkax = 0;
+}
+
+void rbg0_init(const Rbg0Config* config) {
+    u32 coef_entry = config->coef_addr >> 2;
+    u32 bank = config->coef_addr / VDP2_VRAM_BANK_SIZE;
+    u32 table = (config->param_addr >> 1) & 0x7FFFE;
+
+    param_addr = config->param_addr;
+    coef_addr = config->coef_addr;
+    sky_enabled = config->sky;
+    sky_height = (s32)config->sky_height;
+
+    vdp2_reg_modify(&VDP2_RAMCTL, 0x0300 | (0x3 << (bank * 2)), 0x0300 | (0x1 << (bank * 2)));
+    vdp2_reg_write(&VDP2_RPTAU, (u16)(table >> 16));
+    vdp2_reg_write(&VDP2_RPTAL, (u16)table);
+    vdp2_reg_write(&VDP2_RPRCTL, sky_enabled ? 0x0707 : 0x0007);
+    vdp2_reg_write(&VDP2_KTCTL, sky_enabled ? 0x0101 : 0x0001);
+    vdp2_reg_write(&VDP2_KTAOF, (u16)(((coef_entry >> 16) & 0x7) * 0x0101));
+    vdp2_reg_write(&VDP2_RPMD, sky_enabled ? 0x0002 : 0x0000);
+    vdp2_set_priority(BG_RBG0, config->priority);
+    vdp2_enable_bg(BG_RBG0);
+}
+
+void rbg0_set_camera(const Rbg0Camera* camera) {
+    u32 coef_entry = (coef_addr >> 2) & 0xFFFF;
+    s32 sin_p = (s32)fix16_sin(camera->pitch);
+    s32 cos_p = (s32)fix16_cos(camera->pitch);
+    s32 dist_sin = fx_mul((s32)camera->distance, sin_p);
+    s32 height = (s32)camera->height;
+    s32 lines = display_height();
+    s32 center = lines / 2;
+
+    if (lines > RBG0_MAX_LINES) {
+        lines = RBG0_MAX_LINES;
+    }
+    coef_lines = (u32)lines;
+
+    build_table(&params[0], camera, coef_entry, sin_p, cos_p);
+    if (sky_enabled) {
+        build_table(&params[1], camera, coef_entry + RBG0_MAX_LINES, sin_p, cos_p);
+    }
+
+    for (s32 line = 0; line < lines; line++) {
+        s32 denom = fx_mul((line - center) << FIX16_SHIFT, cos_p) + dist_sin;
+        coefs[0][line] = line_coef(height, denom);
+        if (sky_enabled) {
+            coefs[1][line] = line_coef(sky_height, -denom);
+        }
+    }
+}
+
+void rbg0_upload(void) {
+    upload_submit(params, VDP2_VRAM + param_addr, sizeof(params), DMA_PRIORITY_HIGH, 0);
+    if (coef_lines == 0) {
+        return;
+    }
+    upload_submit(coefs[0], VDP2_VRAM + coef_addr, coef_lines * 4, DMA_PRIORITY_HIGH, 0);
+    if (sky_enabled) {
+        upload_submit(coefs[1], VDP2_VRAM + coef_addr + sizeof(coefs[0]), coef_lines * 4,
+                      DMA_PRIORITY_HIGH, 0);
+    }
+}
@@ -0,0 +1,40 @@
+#include "saturn/vdp2.h"
+#include "saturn/hardware.h"
+
+#define VDP2_REG_COUNT (VDP2_REGS_SIZE / 2)
+
+static u16 shadow[VDP2_REG_COUNT];
+static u32 dirty[(VDP2_REG_COUNT + 31) / 32];
+
+static inline u32 reg_index(volatile u16* reg) {
+    return ((u32)reg - VDP2_REGS) >> 1;
+}
+
+void vdp2_reg_write(volatile u16* reg, u16 value) {
+    u32 i = reg_index(reg);
+    shadow[i] = value;
+    dirty[i >> 5] |= 1u << (i & 31);
+}
+
+void vdp2_reg_modify(volatile u16* reg, u16 mask, u16 value) {
+    u32 i = reg_index(reg);
+    vdp2_reg_write(reg, (shadow[i] & ~mask) | (value & mask));
+}
+
+u16 vdp2_reg_read(volatile u16* reg) {
+    return shadow[reg_index(reg)];
+}
+
+void vdp2_commit(void) {
+    volatile u16* regs = (volatile u16*)VDP2_REGS;
+
+    for (u32 w = 0; w < sizeof(dirty) / sizeof(dirty[0]); w++) {
+        u32 bits = dirty[w];
+        dirty[w] = 0;
+        for (u32 i = w << 5; bits; i++, bits >>= 1) {
+            if (bits & 1) {
+                regs[i] = shadow[i];
+            }
+        }
+    }
+}
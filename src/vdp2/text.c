@@ -0,0 +1,274 @@
+#include "saturn/text.h"
+#include "saturn/vdp2.h"
+#include "saturn/upload.h"
+#include "saturn/shared.h"
+#include "saturn/display.h"
+#include "saturn/hardware.h"
+#include <stdarg.h>
+
+#define CELL_SIZE    0x20
+#define PAGE_SIZE    0x2000
+#define BLANK_CELL   0
+
+static volatile u16* const chctl_reg[4] = { &VDP2_CHCTLA, &VDP2_CHCTLA, &VDP2_CHCTLB, &VDP2_CHCTLB };
+static const u16 chctl_mask[4] = { 0x007F, 0x3F00, 0x0003, 0x0030 };
+static volatile u16* const pncn_reg[4] = { &VDP2_PNCN0, &VDP2_PNCN1, &VDP2_PNCN2, &VDP2_PNCN3 };
+static volatile u16* const mpab_reg[4] = { &VDP2_MPABN0, &VDP2_MPABN1, &VDP2_MPABN2, &VDP2_MPABN3 };
+static volatile u16* const mpcd_reg[4] = { &VDP2_MPCDN0, &VDP2_MPCDN1, &VDP2_MPCDN2, &VDP2_MPCDN3 };
+static volatile u16* const scx_reg[4] = { &VDP2_SCXIN0, &VDP2_SCXIN1, &VDP2_SCXN2, &VDP2_SCXN3 };
+static volatile u16* const scy_reg[4] = { &VDP2_SCYIN0, &VDP2_SCYIN1, &VDP2_SCYN2, &VDP2_SCYN3 };
+static volatile u16* const cycle_reg[4][2] = {
+    { &VDP2_CYCA0L, &VDP2_CYCA0U },
+    { &VDP2_CYCA1L, &VDP2_CYCA1U },
+    { &VDP2_CYCB0L, &VDP2_CYCB0U },
+    { &VDP2_CYCB1L, &VDP2_CYCB1U }
+};
+
+static const u16 nibble_expand[16] = {
+    0x0000, 0x0001, 0x0010, 0x0011, 0x0100, 0x0101, 0x0110, 0x0111,
+    0x1000, 0x1001, 0x1010, 0x1011, 0x1100, 0x1101, 0x1110, 0x1111
+};
+
+static u16 map[TEXT_MAP_HEIGHT][TEXT_MAP_WIDTH] ALIGN16;
+static u16 glyph_cell[256];
+static u32 next_cell;
+static u32 cell_base;
+static u32 char_addr;
+static u32 map_addr;
+static u16 pn_palette;
+static u32 cursor_x, cursor_y;
+static u32 dirty_lo = TEXT_MAP_HEIGHT;
+static u32 dirty_hi = 0;
+
+static u32 vram_bank(u32 addr) {
+    u32 bank = addr / VDP2_VRAM_BANK_SIZE;
+    u16 ramctl = vdp2_reg_read(&VDP2_RAMCTL);
+    if (bank == 1 && !(ramctl & 0x0100)) return 0;
+    if (bank == 3 && !(ramctl & 0x0200)) return 2;
+    return bank;
+}
+
+static void cycle_claim(u32 bank, u16 code) {
+    for (u32 slot = 0; slot < 4; slot++) {
+        volatile u16* reg = cycle_reg[bank][0];
+        u32 shift = 12 - slot * 4;
+        u16 value = vdp2_reg_read(reg);
+        if (((value >> shift) & 0xF) == code) return;
+        if (((value >> shift) & 0xF) == 0xF) {
+            vdp2_reg_modify(reg, 0xF << shift, code << shift);
+            return;
+        }
+    }
+}
+
+static inline void mark_dirty(u32 row) {
+    if (row < dirty_lo) dirty_lo = row;
+    if (row + 1 > dirty_hi) dirty_hi = row + 1;
+}
+
+static void write_cell(u32 cell, const u8* rows) {
+    volatile u32* dst = (volatile u32*)(VDP2_VRAM + char_addr + cell * CELL_SIZE);
+    for (u32 i = 0; i < 8; i++) {
+        dst[i] = ((u32)nibble_expand[rows[i] >> 4] << 16) | nibble_expand[rows[i] & 0xF];
+    }
+}
+
+static void load_glyph(u8 ch, const u8* rows) {
+    u32 cell = glyph_cell[ch];
+    if (cell == BLANK_CELL) {
+        if (next_cell >= TEXT_MAX_GLYPHS) return;
+        cell = next_cell++;
+        glyph_cell[ch] = (u16)cell;
+    }
+    write_cell(cell, rows);
+}
+
+void text_init(const TextConfig* config) {
+    static const u8 blank[8] = { 0 };
+    u32 layer = config->layer;
+    u32 map_reg = config->map_addr / PAGE_SIZE;
+
+    char_addr = config->char_addr;
+    map_addr = config->map_addr;
+    cell_base = char_addr / CELL_SIZE;
+    pn_palette = (u16)(config->palette << 12);
+    next_cell = BLANK_CELL + 1;
+    for (u32 i = 0; i < 256; i++) {
+        glyph_cell[i] = BLANK_CELL;
+    }
+    write_cell(BLANK_CELL, blank);
+
+    vdp2_reg_modify(chctl_reg[layer], chctl_mask[layer], 0x0000);
+    vdp2_reg_write(pncn_reg[layer], 0x8000 | ((cell_base >> 10) & 0x1F));
+    vdp2_reg_modify(&VDP2_PLSZ, 0x3 << (layer * 2), 0x0000);
+    vdp2_reg_modify(&VDP2_MPOFN, 0x7 << (layer * 4), (map_reg >> 6) << (layer * 4));
+    vdp2_reg_write(mpab_reg[layer], (map_reg & 0x3F) * 0x0101);
+    vdp2_reg_write(mpcd_reg[layer], (map_reg & 0x3F) * 0x0101);
+    vdp2_reg_write(scx_reg[layer], 0);
+    vdp2_reg_write(scy_reg[layer], 0);
+    vdp2_set_priority(config->layer, config->priority);
+    cycle_claim(vram_bank(map_addr), (u16)layer);
+    cycle_claim(vram_bank(char_addr), (u16)(4 + layer));
+    vdp2_enable_bg(config->layer);
+
+    text_clear();
+}
+
+void text_load_font(const u8* rows, u8 first, u32 count) {
+    for (u32 i = 0; i < count && first + i < 256; i++) {
+        load_glyph((u8)(first + i), rows + i * 8);
+    }
+}
+
+void text_load_glyphs(const TextGlyph* glyphs, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        load_glyph((u8)glyphs[i].ch, glyphs[i].rows);
+    }
+}
+
+void text_clear(void) {
+    u16 blank = pn_palette | ((cell_base + BLANK_CELL) & 0x3FF);
+    u32* dst = (u32*)map;
+    u32 pair = ((u32)blank << 16) | blank;
+
+    for (u32 i = 0; i < sizeof(map) / 4; i++) {
+        dst[i] = pair;
+    }
+    cursor_x = 0;
+    cursor_y = 0;
+    dirty_lo = 0;
+    dirty_hi = TEXT_MAP_HEIGHT;
+}
+
+static inline u32 text_columns(void) {
+    u32 columns = display_width() / 8;
+    return columns < TEXT_MAP_WIDTH ? columns : TEXT_MAP_WIDTH;
+}
+
+void text_locate(u32 x, u32 y) {
+    u32 columns = text_columns();
+
+    cursor_x = x < columns ? x : columns - 1;
+    cursor_y = y % TEXT_MAP_HEIGHT;
+}
+
+void text_set_palette(u8 palette) {
+    pn_palette = (u16)(palette << 12);
+}
+
+void text_putc(char ch) {
+    if (ch == '\n' || cursor_x >= text_columns()) {
+        cursor_x = 0;
+        cursor_y = (cursor_y + 1) % TEXT_MAP_HEIGHT;
+        if (ch == '\n') return;
+    }
+    map[cursor_y][cursor_x++] = pn_palette | ((cell_base + glyph_cell[(u8)ch]) & 0x3FF);
+    mark_dirty(cursor_y);
+}
+
+void text_puts(const char* str) {
+    while (*str) {
+        text_putc(*str++);
+    }
+}
+
+void text_print(u32 x, u32 y, const char* str) {
+    text_locate(x, y);
+    text_puts(str);
+}
+
+static u32 format_uint(char* out, u32 value, u32 base, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[10];
+    u32 n = 0;
+
+    do {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while (value);
+    for (u32 i = 0; i < n; i++) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+static u32 format_args(char* out, u32 size, const char* fmt, va_list ap) {
+    u32 len = 0;
+
+    while (*fmt && len + 1 < size) {
+        char field[12];
+        const char* str = field;
+        u32 n = 0, width = 0;
+        bool left = false, zero = false, negative = false;
+
+        if (*fmt != '%') {
+            out[len++] = *fmt++;
+            continue;
+        }
+        fmt++;
+        for (; *fmt == '-' || *fmt == '0'; fmt++) {
+            if (*fmt == '-') left = true;
+            else zero = true;
+        }
+        for (; *fmt >= '0' && *fmt <= '9'; fmt++) {
+            width = width * 10 + (u32)(*fmt - '0');
+        }
+
+        switch (*fmt) {
+            case 'd':
+            case 'i': {
+                s32 v = va_arg(ap, s32);
+                negative = v < 0;
+                n = format_uint(field, negative ? (u32)-v : (u32)v, 10, false);
+                break;
+            }
+            case 'u': n = format_uint(field, va_arg(ap, u32), 10, false); break;
+            case 'x': n = format_uint(field, va_arg(ap, u32), 16, false); break;
+            case 'X': n = format_uint(field, va_arg(ap, u32), 16, true); break;
+            case 'p': n = format_uint(field, (u32)va_arg(ap, void*), 16, false); break;
+            case 'c': field[0] = (char)va_arg(ap, int); n = 1; break;
+            case 's':
+                str = va_arg(ap, const char*);
+                while (str[n]) n++;
+                break;
+            case '\0':
+                out[len] = '\0';
+                return len;
+            default: field[0] = *fmt; n = 1; break;
+        }
+        fmt++;
+
+        u32 total = n + (negative ? 1 : 0);
+        u32 pad = width > total ? width - total : 0;
+        if (negative && zero && len + 1 < size) out[len++] = '-';
+        for (; !left && pad && len + 1 < size; pad--) out[len++] = zero ? '0' : ' ';
+        if (negative && !zero && len + 1 < size) out[len++] = '-';
+        for (u32 i = 0; i < n && len + 1 < size; i++) out[len++] = str[i];
+        for (; pad && len + 1 < size; pad--) out[len++] = ' ';
+    }
+    out[len] = '\0';
+    return len;
+}
+
+void text_printf(u32 x, u32 y, const char* fmt, ...) {
+    char buf[TEXT_MAP_WIDTH + 1];
+    va_list ap;
+
+    va_start(ap, fmt);
+    format_args(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    text_print(x, y, buf);
+}
+
+void text_upload(void) {
+    if (dirty_lo >= dirty_hi) {
+        return;
+    }
+
+    // With the scheduler full the rows stay dirty for the next call.
+    if (upload_submit(&map[dirty_lo][0], VDP2_VRAM + map_addr + dirty_lo * sizeof(map[0]),
+                      (dirty_hi - dirty_lo) * sizeof(map[0]), DMA_PRIORITY_NORMAL, 1)) {
+        dirty_lo = TEXT_MAP_HEIGHT;
+        dirty_hi = 0;
+    }
+}
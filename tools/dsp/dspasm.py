@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+import sys
+import re
+import argparse
+
+# Data RAM read sources. D1 additionally reads the ALU output.
+RAM_SRC = {'M0': 0, 'M1': 1, 'M2': 2, 'M3': 3, 'MC0': 4, 'MC1': 5, 'MC2': 6, 'MC3': 7}
+D1_SRC = dict(RAM_SRC, ALL=9, ALH=10)
+D1_DEST = {'MC0': 0, 'MC1': 1, 'MC2': 2, 'MC3': 3, 'RX': 4, 'PL': 5, 'RA0': 6, 'WA0': 7,
+           'LOP': 10, 'TOP': 11, 'CT0': 12, 'CT1': 13, 'CT2': 14, 'CT3': 15}
+MVI_DEST = {'MC0': 0, 'MC1': 1, 'MC2': 2, 'MC3': 3, 'RX': 4, 'PL': 5, 'RA0': 6, 'WA0': 7,
+            'LOP': 10, 'PC': 12}
+DMA_RAM = {'MC0': 0, 'MC1': 1, 'MC2': 2, 'MC3': 3, 'PRG': 4}
+ALU_OPS = {'NOP': 0x0, 'AND': 0x1, 'OR': 0x2, 'XOR': 0x3, 'ADD': 0x4, 'SUB': 0x5, 'AD2': 0x6,
+           'SR': 0x8, 'RR': 0x9, 'SL': 0xA, 'RL': 0xB, 'RL8': 0xF}
+CONDITIONS = {'NZ': 0x41, 'NS': 0x42, 'NZS': 0x43, 'NC': 0x44, 'NT0': 0x48,
+              'Z': 0x61, 'S': 0x62, 'ZS': 0x63, 'C': 0x64, 'T0': 0x68}
+
+# Address increments per DMA direction (ADD field).
+DMA_READ_ADD = 1
+DMA_WRITE_ADD = 2
+
+OP_DMA = 0xC0000000
+OP_JMP = 0xD0000000
+OP_BTM = 0xE0000000
+OP_LPS = 0xE8000000
+OP_END = 0xF0000000
+OP_ENDI = 0xF8000000
+
+
+class AsmError(Exception):
+    pass
+
+
+def parse_number(text, labels):
+    text = text.strip().lstrip('#')
+    if text in labels:
+        return labels[text]
+    try:
+        if text.startswith('$'):
+            return int(text[1:], 16)
+        return int(text, 0)
+    except ValueError:
+        raise AsmError(f"bad number or unknown label '{text}'")
+
+
+def encode_operation(tokens, labels):
+    word = 0
+    alu = x = p = y = a = d1 = False
+    i = 0
+
+    while i < len(tokens):
+        tok = tokens[i]
+        if tok in ALU_OPS:
+            if alu:
+                raise AsmError("two ALU operations")
+            word |= ALU_OPS[tok] << 26
+            alu = True
+            i += 1
+            continue
+        if tok == 'CLR':
+            if i + 1 >= len(tokens) or tokens[i + 1] != 'A' or a:
+                raise AsmError("expected CLR A")
+            word |= 0x00020000
+            a = True
+            i += 2
+            continue
+        if tok != 'MOV' or i + 1 >= len(tokens):
+            raise AsmError(f"unexpected '{tok}'")
+
+        src, _, dst = tokens[i + 1].partition(',')
+        i += 2
+        if dst == 'X' and src in RAM_SRC and not x:
+            word |= 0x02000000 | RAM_SRC[src] << 20
+            x = True
+        elif dst == 'P' and src == 'MUL' and not p:
+            word |= 0x01000000
+            p = True
+        elif dst == 'P' and src in RAM_SRC and not p and not x:
+            word |= 0x01800000 | RAM_SRC[src] << 20
+            p = x = True
+        elif dst == 'Y' and src in RAM_SRC and not y:
+            word |= 0x00080000 | RAM_SRC[src] << 14
+            y = True
+        elif dst == 'A' and src == 'ALU' and not a:
+            word |= 0x00040000
+            a = True
+        elif dst == 'A' and src in RAM_SRC and not a and not y:
+            word |= 0x00060000 | RAM_SRC[src] << 14
+            a = y = True
+        elif dst in D1_DEST and not d1:
+            if src in D1_SRC:
+                word |= 0x00003000 | D1_DEST[dst] << 8 | D1_SRC[src]
+            else:
+                value = parse_number(src, labels)
+                if not -128 <= value <= 255:
+                    raise AsmError(f"immediate {value} out of range")
+                word |= 0x00001000 | D1_DEST[dst] << 8 | (value & 0xFF)
+            d1 = True
+        else:
+            raise AsmError(f"cannot encode MOV {src},{dst}")
+    return word
+
+
+def encode_mvi(operand, labels):
+    parts = operand.split(',')
+    if len(parts) not in (2, 3) or parts[1] not in MVI_DEST:
+        raise AsmError("expected MVI imm,dest[,cond]")
+    value = parse_number(parts[0], labels)
+    word = 0x80000000 | MVI_DEST[parts[1]] << 26
+    if len(parts) == 3:
+        if parts[2] not in CONDITIONS:
+            raise AsmError(f"unknown condition '{parts[2]}'")
+        return word | 0x02000000 | (CONDITIONS[parts[2]] & 0x3F) << 19 | (value & 0x7FFFF)
+    return word | (value & 0x01FFFFFF)
+
+
+def encode_dma(mnemonic, operand, labels):
+    parts = operand.split(',')
+    if len(parts) != 3:
+        raise AsmError("expected DMA src,dst,count")
+    word = OP_DMA
+    if mnemonic == 'DMAH':
+        word |= 1 << 14
+    if parts[0] == 'D0' and parts[1] in DMA_RAM:
+        word |= DMA_READ_ADD << 15 | DMA_RAM[parts[1]] << 8
+    elif parts[1] == 'D0' and parts[0] in DMA_RAM and parts[0] != 'PRG':
+        word |= DMA_WRITE_ADD << 15 | 1 << 12 | DMA_RAM[parts[0]] << 8
+    else:
+        raise AsmError("DMA needs D0 on one side")
+    if parts[2] in RAM_SRC:
+        return word | 1 << 13 | RAM_SRC[parts[2]]
+    count = parse_number(parts[2], labels)
+    if not 0 <= count <= 255:
+        raise AsmError(f"DMA count {count} out of range")
+    return word | count
+
+
+def encode_jmp(operand, labels):
+    parts = operand.split(',')
+    if len(parts) == 1:
+        return OP_JMP | (parse_number(parts[0], labels) & 0xFF)
+    if parts[0] not in CONDITIONS:
+        raise AsmError(f"unknown condition '{parts[0]}'")
+    return OP_JMP | CONDITIONS[parts[0]] << 19 | (parse_number(parts[1], labels) & 0xFF)
+
+
+def encode(tokens, labels):
+    mnemonic = tokens[0]
+    operand = tokens[1] if len(tokens) > 1 else ''
+
+    if mnemonic == 'MVI':
+        return encode_mvi(operand, labels)
+    if mnemonic in ('DMA', 'DMAH'):
+        return encode_dma(mnemonic, operand, labels)
+    if mnemonic == 'JMP':
+        return encode_jmp(operand, labels)
+    if mnemonic in ('BTM', 'LPS', 'END', 'ENDI') and len(tokens) == 1:
+        return {'BTM': OP_BTM, 'LPS': OP_LPS, 'END': OP_END, 'ENDI': OP_ENDI}[mnemonic]
+    return encode_operation(tokens, labels)
+
+
+def tokenize(line):
+    line = line.split(';')[0].upper()
+    # Glue operand lists back together: "MOV MC3, X" -> "MOV MC3,X".
+    line = re.sub(r'\s*,\s*', ',', line)
+    return line.split()
+
+
+def assemble(source):
+    lines = []
+    labels = {}
+
+    for number, raw in enumerate(source.splitlines(), 1):
+        tokens = tokenize(raw)
+        while tokens and tokens[0].endswith(':'):
+            labels[tokens[0][:-1]] = len(lines)
+            tokens = tokens[1:]
+        if tokens:
+            lines.append((number, raw.split(';')[0].strip(), tokens))
+
+    program = []
+    for number, text, tokens in lines:
+        try:
+            program.append((encode(tokens, labels), text))
+        except AsmError as e:
+            raise AsmError(f"line {number}: {e}")
+    if len(program) > 256:
+        raise AsmError(f"program is {len(program)} words, program RAM holds 256")
+    return program, labels
+
+
+def to_c(program, labels, name):
+    # Branch targets are marked with their address, as in src/dsp/jobs.c.
+    targets = set(labels.values())
+    out = [f"static const u32 {name}[] = {{"]
+    for addr, (word, text) in enumerate(program):
+        mark = f"{addr}:" if addr in targets else ""
+        text = ''.join(str(labels.get(tok.upper(), tok)) for tok in re.split(r'(\W)', text))
+        out.append(f"    0x{word:08X}, // {mark:<3} {text}")
+    out.append("};")
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Assemble SCU DSP microcode')
+    parser.add_argument('input', help='Input .dsp source')
+    parser.add_argument('output', nargs='?', help='Output .c file (default: stdout)')
+    parser.add_argument('--name', default='dsp_program', help='Array name (default: dsp_program)')
+    args = parser.parse_args()
+
+    with open(args.input, 'r') as f:
+        source = f.read()
+
+    try:
+        program, labels = assemble(source)
+    except AsmError as e:
+        print(f"{args.input}: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    text = to_c(program, labels, args.name)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+        print(f"Assembled {len(program)} words from {args.input} to {args.output}")
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
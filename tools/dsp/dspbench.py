@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+import os
+import sys
+import ctypes
+import random
+import argparse
+import tempfile
+import subprocess
+
+import dspasm
+import dspsim
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+
+KERNELS = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'kernels')
+
+# Same layout as src/dsp/jobs.c.
+TRANSFORM_BLOCK = 21
+OUTCODE_BLOCK = 20
+PARAM_BANK = 3
+PARAM_OFFSET = 3
+FIX16_ONE = 0x10000
+
+CLIP_LEFT, CLIP_RIGHT, CLIP_TOP, CLIP_BOTTOM, CLIP_NEAR, CLIP_FAR = (1 << i for i in range(6))
+OUTCODE_WEIGHTS = [-CLIP_LEFT, CLIP_RIGHT, -CLIP_TOP, CLIP_BOTTOM, -CLIP_NEAR, CLIP_FAR]
+
+MATRIX_ADDR = 0x06040000
+SRC_ADDR = 0x06041000
+DST_ADDR = 0x06050000
+
+# fix16_mul truncates each product, the DSP truncates the sum of four.
+TOLERANCE = 3
+
+
+class Vec3(ctypes.Structure):
+    _fields_ = [('x', ctypes.c_uint32), ('y', ctypes.c_uint32), ('z', ctypes.c_uint32)]
+
+
+class Mat4(ctypes.Structure):
+    _fields_ = [('m', (ctypes.c_uint32 * 4) * 4)]
+
+
+def build_reference(workdir):
+    lib = os.path.join(workdir, 'libref.so')
+    sources = [os.path.join(ROOT, 'src', 'math', name) for name in ('fixed.c', 'vector.c', 'matrix.c')]
+    cmd = ['gcc', '-O2', '-shared', '-fPIC', '-I', os.path.join(ROOT, 'include'), '-o', lib] + sources + ['-lm']
+    subprocess.run(cmd, check=True)
+    return ctypes.CDLL(lib)
+
+
+def fix16(value):
+    return int(round(value * FIX16_ONE)) & 0xFFFFFFFF
+
+
+def run_transform(program, matrix, vertices, dma_cycles):
+    dsp = dspsim.Dsp(dma_cycles=dma_cycles)
+    dsp.load_program(program)
+
+    # DspMatrix is the transposed upper 3x4 of the Mat4.
+    rows = [matrix.m[k][r] for r in range(3) for k in range(4)]
+    for i, word in enumerate(rows):
+        dsp.mem.write(MATRIX_ADDR + i * 4, word)
+    for i, (x, y, z) in enumerate(vertices):
+        for j, word in enumerate((x, y, z)):
+            dsp.mem.write(SRC_ADDR + i * 12 + j * 4, word)
+
+    cycles = 0
+    done = 0
+    while done < len(vertices):
+        count = min(TRANSFORM_BLOCK, len(vertices) - done)
+        dsp.write_data(PARAM_BANK, PARAM_OFFSET, [
+            FIX16_ONE,
+            MATRIX_ADDR >> 2,
+            (SRC_ADDR + done * 12) >> 2,
+            (DST_ADDR + done * 12) >> 2,
+            count * 3,
+            count - 1,
+        ])
+        cycles += dsp.run()
+        if not dsp.interrupt:
+            raise dspsim.DspHazard("block ended without ENDI")
+        done += count
+
+    result = [tuple(dsp.mem.dump(DST_ADDR + i * 12, 3)) for i in range(len(vertices))]
+    return result, cycles
+
+
+def run_outcode(program, volume, vertices, dma_cycles):
+    dsp = dspsim.Dsp(dma_cycles=dma_cycles)
+    dsp.load_program(program)
+
+    weights = [OUTCODE_WEIGHTS[k] << (24 - v * 8) for v in range(4) for k in range(6)]
+    bias = (CLIP_RIGHT | CLIP_BOTTOM | CLIP_FAR) * 0x01010101
+    x0, x1, y0, y1, z0, z1 = volume
+    bounds = [-x0, ~x1, -y0, ~y1, -z0, ~z1]
+    dsp.write_data(0, 0, weights + [bias])
+    dsp.write_data(0, 40, bounds * 4)
+
+    for i, vertex in enumerate(vertices):
+        for j, word in enumerate(vertex):
+            dsp.mem.write(SRC_ADDR + i * 12 + j * 4, word)
+
+    cycles = 0
+    done = 0
+    while done < len(vertices):
+        count = min(OUTCODE_BLOCK, len(vertices) - done)
+        dsp.write_data(PARAM_BANK, 0, [
+            (SRC_ADDR + done * 12) >> 2,
+            (DST_ADDR + done) >> 2,
+            count * 3,
+            (count + 3) // 4 - 1,
+        ])
+        cycles += dsp.run()
+        if not dsp.interrupt:
+            raise dspsim.DspHazard("block ended without ENDI")
+        done += count
+
+    data = b''.join(word.to_bytes(4, 'big') for word in dsp.mem.dump(DST_ADDR, (len(vertices) + 3) // 4))
+    return list(data[:len(vertices)]), cycles
+
+
+def outcode(volume, vertex):
+    x, y, z = (dspsim.sext(c, 32) for c in vertex)
+    x0, x1, y0, y1, z0, z1 = (dspsim.sext(c, 32) for c in volume)
+    return ((x < x0) * CLIP_LEFT | (x > x1) * CLIP_RIGHT | (y < y0) * CLIP_TOP |
+            (y > y1) * CLIP_BOTTOM | (z < z0) * CLIP_NEAR | (z > z1) * CLIP_FAR)
+
+
+def bench_transform(program, rng, args):
+    matrix = Mat4()
+    for k in range(4):
+        for r in range(4):
+            scale = 256.0 if k == 3 else 4.0
+            matrix.m[k][r] = fix16(rng.uniform(-scale, scale))
+    vertices = [tuple(fix16(rng.uniform(-512.0, 512.0)) for _ in range(3)) for _ in range(args.count)]
+
+    with tempfile.TemporaryDirectory() as workdir:
+        ref = build_reference(workdir)
+        expected = []
+        for x, y, z in vertices:
+            v = Vec3(x, y, z)
+            out = Vec3()
+            ref.vec3_transform(ctypes.byref(v), ctypes.byref(matrix), ctypes.byref(out))
+            expected.append((out.x, out.y, out.z))
+
+    result, cycles = run_transform(program, matrix, vertices, args.dma_cycles)
+
+    worst = 0
+    failures = 0
+    for i, (got, want) in enumerate(zip(result, expected)):
+        error = max(abs(dspsim.sext(g - w, 32)) for g, w in zip(got, want))
+        worst = max(worst, error)
+        if error > TOLERANCE:
+            if failures < 10:
+                print(f"vertex {i}: got {' '.join(f'{g:08X}' for g in got)}, "
+                      f"expected {' '.join(f'{w:08X}' for w in want)}")
+            failures += 1
+    return cycles, failures, f"max error {worst} LSB"
+
+
+def bench_outcode(program, rng, args):
+    volume = [fix16(v) for v in (0.0, 319.0, 0.0, 223.0, 1.0, 1024.0)]
+    vertices = [(fix16(rng.uniform(-160.0, 480.0)), fix16(rng.uniform(-112.0, 336.0)),
+                 fix16(rng.uniform(-64.0, 1536.0))) for _ in range(args.count)]
+    # Vertices on the bounds and at the range limits.
+    vertices[:3] = [(volume[0], volume[3], volume[4]), (volume[1], volume[2], volume[5]),
+                    (0x80000000, 0x7FFFFFFF, 0x80000000)][:args.count]
+
+    result, cycles = run_outcode(program, volume, vertices, args.dma_cycles)
+
+    failures = 0
+    for i, (got, vertex) in enumerate(zip(result, vertices)):
+        want = outcode(volume, vertex)
+        if got != want:
+            if failures < 10:
+                print(f"vertex {i}: got {got:02X}, expected {want:02X}")
+            failures += 1
+    return cycles, failures, "exact"
+
+
+JOBS = {
+    'transform': bench_transform,
+    'outcode': bench_outcode,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check and time DSP kernels against reference results')
+    parser.add_argument('job', choices=sorted(JOBS), help='Stock DSP job to check')
+    parser.add_argument('--kernel', help='Kernel source (default: kernels/<job>.dsp)')
+    parser.add_argument('--count', type=int, default=1000, help='Vertices to process (default: 1000)')
+    parser.add_argument('--seed', type=int, default=1, help='Random seed (default: 1)')
+    parser.add_argument('--dma-cycles', type=int, default=dspsim.DMA_CYCLES_PER_WORD,
+                        help=f'Cycles per DMA word (default: {dspsim.DMA_CYCLES_PER_WORD})')
+    args = parser.parse_args()
+
+    kernel = args.kernel or os.path.join(KERNELS, f"{args.job}.dsp")
+    with open(kernel, 'r') as f:
+        try:
+            program = [word for word, _ in dspasm.assemble(f.read())[0]]
+        except dspasm.AsmError as e:
+            print(f"{kernel}: {e}", file=sys.stderr)
+            sys.exit(1)
+
+    try:
+        cycles, failures, accuracy = JOBS[args.job](program, random.Random(args.seed), args)
+    except dspsim.DspHazard as e:
+        print(f"{kernel}: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    print(f"{args.count} vertices, {cycles} cycles, {cycles / args.count:.2f} cycles/vertex, {accuracy}")
+    if failures:
+        print(f"{failures} vertices wrong", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,387 @@
+#!/usr/bin/env python3
+import sys
+import struct
+import argparse
+
+import dspasm
+
+MASK32 = 0xFFFFFFFF
+MASK48 = 0xFFFFFFFFFFFF
+
+FLAG_Z = 0x1
+FLAG_S = 0x2
+FLAG_C = 0x4
+FLAG_T0 = 0x8
+
+# Bus cycles per 32-bit word moved by the DSP DMA. WRAM-H is the usual
+# source; A-bus and VDP targets are slower. Measured numbers replace
+# these once the kernels run on hardware.
+DMA_CYCLES_PER_WORD = 2
+
+READ_ADD = [0, 4]
+WRITE_ADD = [0, 2, 4, 8, 16, 32, 64, 128]
+
+
+class DspHazard(Exception):
+    pass
+
+
+def sext(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+class Memory:
+    """Sparse big-endian view of the SCU-visible address space."""
+
+    def __init__(self):
+        self.words = {}
+
+    def read(self, addr):
+        return self.words.get(addr & 0x07FFFFFC, 0)
+
+    def write(self, addr, value):
+        self.words[addr & 0x07FFFFFC] = value & MASK32
+
+    def load(self, addr, data):
+        data = data + b'\0' * (-len(data) % 4)
+        for i, (word,) in enumerate(struct.iter_unpack('>I', data)):
+            self.write(addr + i * 4, word)
+
+    def dump(self, addr, count):
+        return [self.read(addr + i * 4) for i in range(count)]
+
+
+class Dsp:
+    def __init__(self, memory=None, dma_cycles=DMA_CYCLES_PER_WORD):
+        self.mem = memory if memory is not None else Memory()
+        self.dma_cycles = dma_cycles
+        self.program = [0] * 256
+        self.data = [[0] * 64 for _ in range(4)]
+        self.reset()
+
+    def reset(self):
+        self.ct = [0] * 4
+        self.rx = self.ry = 0
+        self.p = self.a = self.alu = 0
+        self.flags = 0
+        self.ra0 = self.wa0 = 0
+        self.lop = self.top = 0
+        self.pc = 0
+        self.delay = None
+        self.repeat = False
+        self.running = False
+        self.ended = False
+        self.interrupt = False
+        self.cycles = 0
+        self.dma_busy = 0
+        self.dma_bank = None
+        self.dma_words = 0
+
+    def load_program(self, words, pc=0):
+        for i, word in enumerate(words):
+            self.program[(pc + i) & 0xFF] = word & MASK32
+
+    def write_data(self, bank, offset, words):
+        for i, word in enumerate(words):
+            self.data[bank][(offset + i) & 0x3F] = word & MASK32
+
+    def read_data(self, bank, offset, count):
+        return [self.data[bank][(offset + i) & 0x3F] for i in range(count)]
+
+    # Data RAM ports. MCn post-increments CTn once per instruction, no
+    # matter how many buses read it.
+    def _check_bank(self, bank):
+        if self.dma_busy and self.dma_bank == bank:
+            raise DspHazard(f"pc {self.pc:02X}: bank {bank} accessed during DMA")
+
+    def _ram_read(self, src, inc):
+        bank = src & 3
+        self._check_bank(bank)
+        if src & 4:
+            inc.add(bank)
+        return self.data[bank][self.ct[bank]]
+
+    def _condition(self, cond):
+        selected = self.flags & cond & 0xF
+        return bool(selected) if cond & 0x20 else not selected
+
+    def _alu(self, op):
+        acl = self.a & MASK32
+        pl = self.p & MASK32
+        high = self.a & ~MASK32 & MASK48
+
+        if op == 0x0:
+            return
+        if op in (0x1, 0x2, 0x3, 0x4, 0x5):
+            if op == 0x1:
+                res = acl & pl
+            elif op == 0x2:
+                res = acl | pl
+            elif op == 0x3:
+                res = acl ^ pl
+            elif op == 0x4:
+                res = acl + pl
+            else:
+                res = acl - pl
+            carry = res >> 32 & 1 if op in (0x4, 0x5) else 0
+            res &= MASK32
+            self._set_flags(res == 0, res >> 31, carry)
+            self.alu = high | res
+        elif op == 0x6:
+            res = (self.a & MASK48) + (self.p & MASK48)
+            carry = res >> 48 & 1
+            res &= MASK48
+            self._set_flags(res == 0, res >> 47, carry)
+            self.alu = res
+        elif op in (0x8, 0x9, 0xA, 0xB, 0xF):
+            if op == 0x8:
+                res, carry = (sext(acl, 32) >> 1) & MASK32, acl & 1
+            elif op == 0x9:
+                res, carry = (acl >> 1) | (acl & 1) << 31, acl & 1
+            elif op == 0xA:
+                res, carry = (acl << 1) & MASK32, acl >> 31
+            elif op == 0xB:
+                res, carry = ((acl << 1) | (acl >> 31)) & MASK32, acl >> 31
+            else:
+                res, carry = ((acl << 8) | (acl >> 24)) & MASK32, acl >> 24 & 1
+            self._set_flags(res == 0, res >> 31, carry)
+            self.alu = high | res
+        else:
+            raise DspHazard(f"pc {self.pc:02X}: undefined ALU op {op:X}")
+
+    def _set_flags(self, zero, sign, carry):
+        self.flags &= ~(FLAG_Z | FLAG_S | FLAG_C)
+        self.flags |= (FLAG_Z if zero else 0) | (FLAG_S if sign else 0) | (FLAG_C if carry else 0)
+
+    def _operation(self, word):
+        inc = set()
+        old_alu = self.alu
+        old_rx, old_ry = self.rx, self.ry
+        rx, ry, p, a = self.rx, self.ry, self.p, self.a
+
+        self._alu(word >> 26 & 0xF)
+
+        # X bus
+        if word & 0x02000000:
+            rx = self._ram_read(word >> 20 & 7, inc)
+        if (word >> 23 & 3) == 2:
+            p = sext(old_rx, 32) * sext(old_ry, 32) & MASK48
+        elif (word >> 23 & 3) == 3:
+            p = sext(self._ram_read(word >> 20 & 7, inc), 32) & MASK48
+
+        # Y bus
+        if word & 0x00080000:
+            ry = self._ram_read(word >> 14 & 7, inc)
+        y = word >> 17 & 3
+        if y == 1:
+            a = 0
+        elif y == 2:
+            a = self.alu
+        elif y == 3:
+            a = sext(self._ram_read(word >> 14 & 7, inc), 32) & MASK48
+
+        self.rx, self.ry, self.p, self.a = rx, ry, p, a
+
+        # D1 bus
+        d1 = word >> 12 & 3
+        if d1 == 0:
+            pass
+        elif d1 == 1 or d1 == 3:
+            if d1 == 1:
+                value = sext(word & 0xFF, 8) & MASK32
+            elif (word & 0xF) == 9:
+                value = old_alu & MASK32
+            elif (word & 0xF) == 10:
+                value = old_alu >> 16 & MASK32
+            else:
+                value = self._ram_read(word & 7, inc)
+            self._d1_write(word >> 8 & 0xF, value, inc)
+        else:
+            raise DspHazard(f"pc {self.pc:02X}: undefined D1 op")
+
+        for bank in inc:
+            self.ct[bank] = (self.ct[bank] + 1) & 0x3F
+
+    def _d1_write(self, dest, value, inc):
+        if dest < 4:
+            self._check_bank(dest)
+            self.data[dest][self.ct[dest]] = value
+            inc.add(dest)
+        elif dest == 4:
+            self.rx = value
+        elif dest == 5:
+            self.p = sext(value, 32) & MASK48
+        elif dest == 6:
+            self.ra0 = value & 0x01FFFFFF
+        elif dest == 7:
+            self.wa0 = value & 0x01FFFFFF
+        elif dest == 10:
+            self.lop = value & 0xFFF
+        elif dest == 11:
+            self.top = value & 0xFF
+        elif dest >= 12:
+            # An explicit CT write wins over this instruction's increment.
+            self.ct[dest - 12] = value & 0x3F
+            inc.discard(dest - 12)
+        else:
+            raise DspHazard(f"pc {self.pc:02X}: undefined D1 destination {dest}")
+
+    def _mvi(self, word):
+        dest = word >> 26 & 0xF
+        if word & 0x02000000:
+            if not self._condition(word >> 19 & 0x3F | 0x40):
+                return
+            value = sext(word, 19)
+        else:
+            value = sext(word, 25)
+        if dest == 12:
+            self.delay = value & 0xFF
+        else:
+            self._d1_write(dest, value & MASK32, set())
+
+    def _dma(self, word):
+        if self.dma_busy:
+            raise DspHazard(f"pc {self.pc:02X}: DMA started while another is active")
+        add = word >> 15 & 7
+        hold = word >> 14 & 1
+        to_d0 = word >> 12 & 1
+        ram = word >> 8 & 7
+        if word & 0x2000:
+            inc = set()
+            count = self._ram_read(word & 7, inc)
+            for bank in inc:
+                self.ct[bank] = (self.ct[bank] + 1) & 0x3F
+        else:
+            count = word & 0xFF
+
+        if to_d0:
+            step = WRITE_ADD[add]
+            addr = self.wa0 << 2
+            for i in range(count):
+                self.mem.write(addr + i * step, self.data[ram & 3][self.ct[ram & 3]])
+                self.ct[ram & 3] = (self.ct[ram & 3] + 1) & 0x3F
+            if not hold:
+                self.wa0 = (self.wa0 + count * step // 4) & 0x01FFFFFF
+        else:
+            step = READ_ADD[add & 1]
+            addr = self.ra0 << 2
+            for i in range(count):
+                value = self.mem.read(addr + i * step)
+                if ram == 4:
+                    self.program[i & 0xFF] = value
+                else:
+                    self.data[ram & 3][self.ct[ram & 3]] = value
+                    self.ct[ram & 3] = (self.ct[ram & 3] + 1) & 0x3F
+            if not hold:
+                self.ra0 = (self.ra0 + count * step // 4) & 0x01FFFFFF
+
+        self.dma_bank = ram if ram < 4 else None
+        self.dma_busy = max(1, count * self.dma_cycles)
+        self.dma_words += count
+        self.flags |= FLAG_T0
+
+    def step(self):
+        word = self.program[self.pc]
+        target = self.delay
+        self.delay = None
+
+        top = word >> 30
+        if top == 0:
+            self._operation(word)
+        elif top == 2:
+            self._mvi(word)
+        elif top == 3:
+            kind = word >> 28 & 3
+            if kind == 0:
+                self._dma(word)
+            elif kind == 1:
+                if self._condition(word >> 19 & 0x7F):
+                    self.delay = word & 0xFF
+            elif kind == 2:
+                if word & 0x08000000:
+                    self.repeat = self.lop != 0
+                elif self.lop:
+                    self.lop = (self.lop - 1) & 0xFFF
+                    self.delay = self.top
+            else:
+                self.running = False
+                self.ended = True
+                self.interrupt = bool(word & 0x08000000)
+                self.cycles += 1
+                return
+        else:
+            raise DspHazard(f"pc {self.pc:02X}: undefined instruction {word:08X}")
+
+        self.cycles += 1
+        if self.dma_busy:
+            self.dma_busy -= 1
+            if not self.dma_busy:
+                self.flags &= ~FLAG_T0
+                self.dma_bank = None
+
+        if self.repeat and top != 3:
+            self.lop = (self.lop - 1) & 0xFFF
+            self.repeat = self.lop != 0
+            return
+        self.pc = (self.pc + 1) & 0xFF if target is None else target
+
+    def run(self, pc=0, max_cycles=1000000):
+        self.pc = pc
+        self.running = True
+        self.ended = False
+        start = self.cycles
+        while self.running:
+            if self.cycles - start >= max_cycles:
+                raise DspHazard(f"no END after {max_cycles} cycles (pc {self.pc:02X})")
+            self.step()
+        return self.cycles - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run SCU DSP microcode on the host')
+    parser.add_argument('input', help='Input .dsp source')
+    parser.add_argument('--data', action='append', default=[], metavar='BANK:OFFSET:W,W,...',
+                        help='Preload data RAM words (hex)')
+    parser.add_argument('--load', action='append', default=[], metavar='ADDR:FILE',
+                        help='Preload a binary file into memory')
+    parser.add_argument('--dump', action='append', default=[], metavar='ADDR:COUNT',
+                        help='Print memory words after the run')
+    parser.add_argument('--dma-cycles', type=int, default=DMA_CYCLES_PER_WORD,
+                        help=f'Cycles per DMA word (default: {DMA_CYCLES_PER_WORD})')
+    args = parser.parse_args()
+
+    with open(args.input, 'r') as f:
+        try:
+            program, _ = dspasm.assemble(f.read())
+        except dspasm.AsmError as e:
+            print(f"{args.input}: {e}", file=sys.stderr)
+            sys.exit(1)
+
+    dsp = Dsp(dma_cycles=args.dma_cycles)
+    dsp.load_program([word for word, _ in program])
+    for spec in args.data:
+        bank, offset, words = spec.split(':')
+        dsp.write_data(int(bank, 0), int(offset, 0), [int(w, 16) for w in words.split(',')])
+    for spec in args.load:
+        addr, path = spec.split(':', 1)
+        with open(path, 'rb') as f:
+            dsp.mem.load(int(addr, 0), f.read())
+
+    try:
+        cycles = dsp.run()
+    except DspHazard as e:
+        print(f"{args.input}: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    print(f"{cycles} cycles, {dsp.dma_words} DMA words, {'ENDI' if dsp.interrupt else 'END'} at {dsp.pc:02X}")
+    for bank in range(4):
+        print(f"bank {bank}: " + ' '.join(f"{w:08X}" for w in dsp.data[bank][:16]))
+    for spec in args.dump:
+        addr, count = (int(x, 0) for x in spec.split(':'))
+        for i, word in enumerate(dsp.mem.dump(addr, count)):
+            print(f"{addr + i * 4:08X}: {word:08X}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,133 @@
+; Clip outcodes for projected vertices, source of outcode_program in
+; src/dsp/jobs.c.
+;
+; Each test is a sign: AD2 forms coord - bound in 48 bits, two ALH
+; passes shift it right by 32 leaving -1 or 0, and a MAC over the 24
+; signs of four vertices adds up the packed outcode word. Max bounds are
+; stored as max + 1 with the bit weight negated, so every test is
+; "coord - bound < 0".
+;
+; Bank 0: [0..23] bit weights, [24] outcode bias, [40..63] negated
+; bounds repeated for four vertices. Bank 1: input vertices.
+; Bank 2: [0..23] differences >> 16. Bank 3: [0] source address,
+; [1] destination address, [2] input word count, [3] group count - 1,
+; [8..31] signs, [32] output word. Addresses are in 32-bit words.
+
+        MOV 0,CT3
+        MOV MC3,RA0
+        MOV MC3,WA0
+        MOV 0,CT1
+        DMA D0,MC1,M3
+wait_input:
+        JMP T0,wait_input
+        NOP
+
+        MOV 3,CT3
+        MOV M3,LOP
+        MOV 40,CT0
+        MOV 0,CT1
+        MOV 0,CT2
+        MOV group,TOP
+
+; Differences, one vertex per six lines: x, x, y, y, z, z.
+group:
+        MOV MC0,P  MOV M1,A
+        AD2  MOV MC0,P  MOV MC1,A
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV M1,A  MOV ALH,MC2
+        AD2  MOV MC0,P  MOV MC1,A  MOV ALH,MC2
+        AD2  MOV ALH,MC2
+        MOV ALH,MC2  CLR A
+
+        MOV 0,CT2
+
+; Signs
+        MOV MC2,P
+        AD2  MOV MC2,P  MOV 8,CT3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV MC2,P  MOV ALH,MC3
+        AD2  MOV ALH,MC3
+        MOV ALH,MC3
+
+        MOV 8,CT3
+
+; Weighted sum of the signs plus the bias.
+        MOV MC3,X  MOV MC0,Y  MOV 0,CT2
+        MOV MUL,P  MOV MC3,X  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV ALU,A
+        AD2  MOV M0,P  MOV ALU,A
+        AD2  MOV ALU,A
+        MOV ALL,MC3
+
+; One output word per group; the DMA finishes long before pass 2 of the
+; next group touches bank 3.
+        MOV 32,CT3
+        DMA MC3,D0,1
+        BTM
+        MOV 40,CT0
+
+wait_output:
+        JMP T0,wait_output
+        NOP
+        ENDI
@@ -0,0 +1,75 @@
+; Batched 3x4 affine transform, source of transform_program in
+; src/dsp/jobs.c.
+;
+; Bank 0: matrix rows. Bank 1: input vertices. Bank 2: output vertices.
+; Bank 3: [0..2] vertex scratch, [3] 1.0, [4] matrix address,
+; [5] source address, [6] destination address, [7] word count,
+; [8] vertex count - 1. Addresses are in 32-bit words.
+
+        MOV 4,CT3
+        MOV MC3,RA0
+        MOV 0,CT0
+        DMA D0,MC0,12
+wait_matrix:
+        JMP T0,wait_matrix
+        NOP
+
+        MOV MC3,RA0
+        MOV MC3,WA0
+        MOV 0,CT1
+        DMA D0,MC1,M3
+wait_input:
+        JMP T0,wait_input
+        NOP
+
+        MOV 8,CT3
+        MOV M3,LOP
+        MOV 0,CT0
+        MOV 0,CT1
+        MOV 0,CT2
+        MOV 0,CT3
+        MOV loop,TOP
+
+; Copy x, y, z to the scratch words in front of 1.0 so one CT3 sweep
+; feeds the multiplier with x, y, z, 1.
+loop:
+        MOV MC1,MC3
+        MOV MC1,MC3
+        MOV MC1,MC3
+        MOV 0,CT3
+
+; Row 0
+        MOV MC3,X  MOV MC0,Y
+        MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+        AD2  MOV ALU,A
+
+; Row 1, storing row 0
+        MOV MC3,X  MOV MC0,Y  MOV ALH,MC2
+        MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+        AD2  MOV ALU,A
+
+; Row 2, storing row 1
+        MOV MC3,X  MOV MC0,Y  MOV ALH,MC2
+        MOV MUL,P  MOV MC3,X  CLR A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV MC3,X  MOV ALU,A  MOV MC0,Y
+        AD2  MOV MUL,P  MOV ALU,A  MOV 0,CT3
+        AD2  MOV ALU,A  MOV 0,CT0
+
+        MOV ALH,MC2
+        BTM
+        NOP
+
+        MOV 0,CT2
+        MOV 7,CT3
+        DMA MC2,D0,M3
+wait_output:
+        JMP T0,wait_output
+        NOP
+        ENDI